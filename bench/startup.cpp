@@ -0,0 +1,143 @@
+/** tscl-bench-startup : mesure le cout du systeme de logs au démarrage et a l'arret d'un processus
+ *
+ * Usage : tscl-bench-startup [-n lancements] [-r logs]
+ *   -n lancements  Nombre de processus lancés (100 par défaut)
+ *   -r logs        Nombre de logs asynchrones envoyés par chaque processus avant l'arret (1000 par défaut)
+ *
+ * Chaque lancement exécute ce meme programme dans un processus fils, qui ajoute un gestionnaire
+ * sur sa sortie standard (un pipe), envoie un premier log, puis les logs asynchrones, et appelle
+ * Logger::shutdown() avant de quitter. Deux durées sont mesurées :
+ *   - démarrage : du lancement du fils a la réception de son premier log
+ *   - arret : de l'appel a shutdown() a la fin du fils, destruction des variables globales comprise
+ */
+
+#include <tscl.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char **environ;
+
+namespace {
+  uint64_t monotonicNow() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+
+  int child(size_t records) {
+    tscl::logger().addHandler<tscl::ConsoleLogHandler>("out");
+    tscl::logger("first log", tscl::Log::Information);
+
+    for (size_t i = 0; i < records; i++) tscl::logger().logAsync("record " + std::to_string(i), tscl::Log::Information);
+
+    // Le parent mesure l'arret a partir de cette ligne, écrite sans passer par le Logger
+    char line[32];
+    int size = std::snprintf(line, sizeof(line), "@%llu\n", static_cast<unsigned long long>(monotonicNow()));
+    if (write(STDOUT_FILENO, line, size) != size) return 1;
+
+    return tscl::logger().shutdown() ? 0 : 2;
+  }
+
+  struct Run {
+    uint64_t startup;
+    uint64_t shutdown;
+  };
+
+  bool run(char const *self, size_t records, Run &res) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+    std::string count = std::to_string(records);
+    char *argv[] = {const_cast<char *>(self), const_cast<char *>("--child"), count.data(), nullptr};
+
+    pid_t pid;
+    uint64_t begin = monotonicNow();
+    int error = posix_spawn(&pid, "/proc/self/exe", &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    if (error) {
+      close(fds[0]);
+      return false;
+    }
+
+    // Le fils écrit ses logs puis la date de l'appel a shutdown(), précédée de '@'
+    std::string output;
+    uint64_t first_log = 0;
+    char buffer[65536];
+
+    for (ssize_t size; (size = read(fds[0], buffer, sizeof(buffer))) > 0;) {
+      if (not first_log) first_log = monotonicNow();
+      output.append(buffer, size);
+    }
+    close(fds[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+    uint64_t end = monotonicNow();
+
+    size_t marker = output.rfind('@');
+    if (not first_log or marker == std::string::npos or not WIFEXITED(status) or WEXITSTATUS(status) != 0) return false;
+
+    res.startup = first_log - begin;
+    res.shutdown = end - std::stoull(output.substr(marker + 1));
+    return true;
+  }
+
+  void report(char const *name, std::vector<uint64_t> values) {
+    std::sort(values.begin(), values.end());
+    auto at = [&](double q) { return values[std::min(values.size() - 1, size_t(q * values.size()))] / 1e3; };
+
+    std::printf("%-10s median %9.1fus  p90 %9.1fus  p99 %9.1fus  max %9.1fus\n", name, at(0.5), at(0.9), at(0.99),
+                values.back() / 1e3);
+  }
+}   // namespace
+
+int main(int argc, char **argv) {
+  if (argc == 3 and std::strcmp(argv[1], "--child") == 0) return child(std::stoull(argv[2]));
+
+  size_t runs = 100;
+  size_t records = 1000;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "-n") == 0) runs = std::max(1ull, std::stoull(argv[i + 1]));
+    else if (std::strcmp(argv[i], "-r") == 0)
+      records = std::stoull(argv[i + 1]);
+    else {
+      std::cerr << "Usage : " << argv[0] << " [-n runs] [-r records]\n";
+      return 1;
+    }
+  }
+
+  std::vector<uint64_t> startup;
+  std::vector<uint64_t> shutdown;
+
+  for (size_t i = 0; i < runs; i++) {
+    Run res;
+    if (not run(argv[0], records, res)) {
+      std::cerr << "Run " << i << " failed\n";
+      return 1;
+    }
+
+    startup.push_back(res.startup);
+    shutdown.push_back(res.shutdown);
+  }
+
+  std::printf("%zu runs, %zu records per run\n", runs, records);
+  report("startup", startup);
+  report("shutdown", shutdown);
+}
@@ -0,0 +1,785 @@
+/** tscl-stress : générateur de charge multi-thread, pour qualifier une version de tscl avant sa mise en production
+ *
+ * Usage : tscl-stress [options]
+ *   -t threads   Nombres de threads producteurs, séparés par des virgules (1,4,16 par défaut)
+ *   -n logs      Nombre de logs envoyés par chaque thread (100000 par défaut)
+ *   -s taille    Distribution de la taille des messages (uniform:16-256 par défaut) :
+ *                  fixed:N, uniform:MIN-MAX, ou pareto:MIN (queue lourde, limitée a 64 Kio)
+ *   -l niveaux   Poids de chaque niveau (debug:10,info:80,warning:8,error:2 par défaut), parmi
+ *                  trace, debug, info, warning et error
+ *   -b rafale    Chaque thread envoie N logs puis attend, par exemple 1000/5ms (continu par défaut)
+ *   -h sorties   Gestionnaires testés, séparés par des virgules (tous par défaut) :
+ *                  stream, compressed, console, socket, shm
+ *   -d dossier   Dossier des fichiers de sortie, répétable (/dev/shm et /var/tmp par défaut, soit
+ *                  un tmpfs et un disque sur la plupart des systemes)
+ *   -m modes     sync, async ou sync,async (sync par défaut)
+ *   -r graine    Graine du générateur aléatoire (1 par défaut), pour reproduire une charge
+ *   -P           Désactive la mesure du verrou principal du Logger, pour en évaluer le cout
+ *   -k           Conserve les fichiers de sortie
+ *
+ * Chaque combinaison (dossier, gestionnaire, mode, threads) utilise un Logger indépendant. Les
+ * messages portent l'identifiant de leur thread et leur rang ("@S3:1234 xxx..."), et les lignes sont
+ * numérotées (stamped). Une fois la sortie relue, les rangs manquants ou en double donnent le nombre
+ * de logs perdus, et les numéros de séquence sont vérifiés par un SequenceChecker. Pour chaque
+ * combinaison sont affichés :
+ *   - le débit des producteurs, puis le débit de bout en bout (jusqu'a l'écriture complete de la sortie)
+ *   - les centiles de la latence d'un appel au Logger, vue par le producteur
+ *   - les durées d'attente et de détention du verrou principal du Logger
+ *   - les logs perdus ou dupliqués, et ceux abandonnés par le gestionnaire lui-meme
+ *
+ * Le code de retour vaut 2 si un log a été perdu ou dupliqué, 1 en cas d'erreur
+ */
+
+#include <tscl.hpp>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+  constexpr size_t max_payload = 64 * 1024;
+  constexpr std::string_view marker = "@S";
+
+  uint64_t monotonicNow() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+
+  std::vector<std::string_view> split(std::string_view str, char separator) {
+    std::vector<std::string_view> res;
+    for (size_t pos; (pos = str.find(separator)) != std::string_view::npos; str.remove_prefix(pos + 1))
+      res.push_back(str.substr(0, pos));
+    res.push_back(str);
+    return res;
+  }
+
+  template<typename T>
+  std::optional<T> parseNumber(std::string_view str) {
+    T res;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), res);
+    if (ec != std::errc() or ptr != str.data() + str.size()) return std::nullopt;
+    return res;
+  }
+
+  /**
+   * @brief Distribution de la taille des messages
+   *
+   */
+  struct SizeDistribution {
+    enum kind_t { Fixed, Uniform, Pareto } kind = Uniform;
+    size_t min = 16;
+    size_t max = 256;
+
+    static std::optional<SizeDistribution> parse(std::string_view str) {
+      size_t colon = str.find(':');
+      if (colon == std::string_view::npos) return std::nullopt;
+
+      std::string_view name = str.substr(0, colon);
+      auto bounds = split(str.substr(colon + 1), '-');
+      auto min = parseNumber<size_t>(bounds[0]);
+      if (not min or *min > max_payload) return std::nullopt;
+
+      if (name == "fixed" and bounds.size() == 1) return SizeDistribution{Fixed, *min, *min};
+      if (name == "pareto" and bounds.size() == 1) return SizeDistribution{Pareto, std::max<size_t>(1, *min), max_payload};
+      if (name != "uniform" or bounds.size() != 2) return std::nullopt;
+
+      auto max = parseNumber<size_t>(bounds[1]);
+      if (not max or *max < *min or *max > max_payload) return std::nullopt;
+      return SizeDistribution{Uniform, *min, *max};
+    }
+
+    size_t operator()(std::mt19937_64 &rng) const {
+      switch (kind) {
+        case Fixed: return min;
+        case Uniform: return std::uniform_int_distribution<size_t>(min, max)(rng);
+        default: {
+          // Pareto d'indice 1.5 : la plupart des messages sont courts, quelques uns tres longs
+          double u = std::uniform_real_distribution<double>(1e-12, 1.0)(rng);
+          return size_t(std::min<double>(max, min / std::pow(u, 1 / 1.5)));
+        }
+      }
+    }
+  };
+
+  /**
+   * @brief Proportion de chaque niveau parmi les logs envoyés
+   *
+   */
+  struct LevelMix {
+    std::vector<double> weights = {0, 10, 80, 8, 2};
+
+    static std::optional<LevelMix> parse(std::string_view str) {
+      static constexpr std::string_view names[] = {"trace", "debug", "info", "warning", "error"};
+
+      LevelMix res;
+      std::fill(res.weights.begin(), res.weights.end(), 0);
+
+      for (auto entry : split(str, ',')) {
+        size_t colon = entry.find(':');
+        auto weight = parseNumber<unsigned>(entry.substr(colon + 1));
+        auto it = std::find(std::begin(names), std::end(names), entry.substr(0, colon));
+        if (colon == std::string_view::npos or not weight or it == std::end(names)) return std::nullopt;
+
+        res.weights[it - std::begin(names)] = *weight;
+      }
+
+      if (std::all_of(res.weights.begin(), res.weights.end(), [](double w) { return w == 0; })) return std::nullopt;
+      return res;
+    }
+  };
+
+  /**
+   * @brief Rafales : burst logs envoyés sans pause, puis une attente de pause
+   *
+   */
+  struct Burst {
+    size_t size = 0;
+    std::chrono::microseconds pause{0};
+
+    static std::optional<Burst> parse(std::string_view str) {
+      size_t slash = str.find('/');
+      if (slash == std::string_view::npos) return std::nullopt;
+
+      auto size = parseNumber<size_t>(str.substr(0, slash));
+      std::string_view duration = str.substr(slash + 1);
+      size_t unit = duration.find_first_not_of("0123456789");
+      auto value = parseNumber<uint64_t>(duration.substr(0, unit));
+      if (not size or not *size or not value or unit == std::string_view::npos) return std::nullopt;
+
+      std::string_view suffix = duration.substr(unit);
+      if (suffix == "us") return Burst{*size, std::chrono::microseconds(*value)};
+      if (suffix == "ms") return Burst{*size, std::chrono::milliseconds(*value)};
+      if (suffix == "s") return Burst{*size, std::chrono::seconds(*value)};
+      return std::nullopt;
+    }
+  };
+
+  struct Options {
+    std::vector<size_t> threads = {1, 4, 16};
+    size_t records = 100000;
+    SizeDistribution sizes;
+    LevelMix levels;
+    Burst burst;
+    std::vector<std::string> handlers;
+    std::vector<std::string> dirs;
+    std::vector<bool> async = {false};
+    uint64_t seed = 1;
+    bool profile_lock = true;
+    bool keep = false;
+  };
+
+  // ==================================================================
+  // ===                         Sorties                            ===
+  // ==================================================================
+
+  /**
+   * @brief Gestionnaire testé : l'installe dans le Logger, puis relit ce qu'il a écrit
+   *
+   */
+  class Target {
+  protected:
+    std::string m_path;
+
+    /**
+     * @brief Vrai pour conserver le fichier de sortie a la destruction (option -k)
+     *
+     */
+    bool m_keep = false;
+
+  public:
+    explicit Target(std::string path) : m_path(std::move(path)) {}
+
+    virtual ~Target() {
+      if (not m_keep) std::remove(m_path.c_str());
+    }
+
+    /**
+     * @brief Ajoute le gestionnaire "stress" au Logger
+     *
+     */
+    virtual bool install(tscl::Logger &logger) = 0;
+
+    /**
+     * @brief Attend que les logs déja transmis au gestionnaire aient atteint le fichier de sortie.
+     * Appelé apres Logger::shutdown()
+     *
+     */
+    virtual void drain() {}
+
+    /**
+     * @brief Libere les ressources utilisées pendant le test. Appelé une fois le Logger détruit
+     *
+     */
+    virtual void close() {}
+
+    /**
+     * @brief Nombre de logs abandonnés par le gestionnaire lui-meme (tampon ou anneau plein)
+     *
+     */
+    virtual size_t dropped() { return 0; }
+
+    /**
+     * @brief Relit le fichier de sortie ligne par ligne
+     *
+     */
+    virtual void read(std::function<void(std::string_view)> const &line) {
+      std::ifstream in(m_path, std::ios::binary);
+      for (std::string str; std::getline(in, str);) line(str);
+    }
+
+    void keep() { m_keep = true; }
+
+    std::string const &path() const { return m_path; }
+  };
+
+  class StreamTarget : public Target {
+  private:
+    bool m_compressed;
+
+  public:
+    StreamTarget(std::string path, bool compressed) : Target(std::move(path)), m_compressed(compressed) {}
+
+    bool install(tscl::Logger &logger) override {
+      logger.addHandler<tscl::StreamLogHandler>("stress", m_path, m_compressed).stamped(true);
+      return true;
+    }
+
+    void read(std::function<void(std::string_view)> const &line) override {
+      if (not m_compressed) return Target::read(line);
+
+      std::ifstream in(m_path, std::ios::binary);
+      tscl::CompressedReader reader(in);
+      std::string partial;
+
+      while (auto block = reader.next()) {
+        std::string_view data(block->data(), block->size());
+        for (size_t end; (end = data.find('\n')) != std::string_view::npos; data.remove_prefix(end + 1)) {
+          partial.append(data.substr(0, end));
+          line(partial);
+          partial.clear();
+        }
+        partial.append(data);
+      }
+    }
+  };
+
+  /**
+   * @brief ConsoleLogHandler, dont la sortie standard est redirigée vers un fichier pendant le test
+   *
+   */
+  class ConsoleTarget : public Target {
+  private:
+    int m_saved = -1;
+
+  public:
+    using Target::Target;
+
+    ~ConsoleTarget() override { close(); }
+
+    bool install(tscl::Logger &logger) override {
+      int fd = open(m_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) return false;
+
+      std::cout.flush();
+      m_saved = dup(STDOUT_FILENO);
+      dup2(fd, STDOUT_FILENO);
+      ::close(fd);
+
+      using tscl::ConsoleLogHandler;
+      logger.addHandler<ConsoleLogHandler>("stress", ConsoleLogHandler::stream_t::Stdout,
+                                           ConsoleLogHandler::color_t::Never)
+              .stamped(true);
+      return true;
+    }
+
+    void close() override {
+      if (m_saved < 0) return;
+
+      dup2(m_saved, STDOUT_FILENO);
+      ::close(m_saved);
+      m_saved = -1;
+    }
+  };
+
+  /**
+   * @brief UnixSocketLogHandler en mode datagramme, recu par un thread écrivant chaque log sur une ligne
+   *
+   */
+  class SocketTarget : public Target {
+  private:
+    std::string m_socket_path;
+    int m_fd = -1;
+    tscl::UnixSocketLogHandler *m_handler = nullptr;
+    size_t m_dropped = 0;
+    std::atomic<bool> m_stop{false};
+    std::thread m_receiver;
+
+    void receive() {
+      std::ofstream out(m_path, std::ios::binary | std::ios::trunc);
+      std::vector<char> buffer(max_payload + 4096);
+
+      while (true) {
+        ssize_t size = recv(m_fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+
+        if (size >= 0) {
+          out.write(buffer.data(), size);
+          out.put('\n');
+        } else if (m_stop.load(std::memory_order_acquire))
+          break;
+        else
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    }
+
+  public:
+    SocketTarget(std::string path, std::string socket_path)
+        : Target(std::move(path)), m_socket_path(std::move(socket_path)) {}
+
+    ~SocketTarget() override { close(); }
+
+    bool install(tscl::Logger &logger) override {
+      sockaddr_un addr{};
+      if (m_socket_path.size() >= sizeof(addr.sun_path)) return false;
+
+      addr.sun_family = AF_UNIX;
+      std::memcpy(addr.sun_path, m_socket_path.c_str(), m_socket_path.size() + 1);
+      unlink(m_socket_path.c_str());
+
+      m_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+      if (m_fd < 0 or bind(m_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) return false;
+
+      int size = 8 * 1024 * 1024;
+      setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+      m_receiver = std::thread(&SocketTarget::receive, this);
+      m_handler = &logger.addHandler<tscl::UnixSocketLogHandler>("stress", m_socket_path);
+      m_handler->stamped(true);
+      return true;
+    }
+
+    void drain() override {
+      // Le handler a envoyé son tampon, le récepteur vide ensuite le socket avant de s'arreter
+      if (m_handler) m_dropped = m_handler->dropped();
+      m_stop.store(true, std::memory_order_release);
+      if (m_receiver.joinable()) m_receiver.join();
+    }
+
+    void close() override {
+      // Le gestionnaire a été détruit avec le Logger
+      m_handler = nullptr;
+      drain();
+
+      if (m_fd >= 0) {
+        ::close(m_fd);
+        unlink(m_socket_path.c_str());
+        m_fd = -1;
+      }
+    }
+
+    size_t dropped() override { return m_dropped; }
+  };
+
+  /**
+   * @brief ShmRingLogHandler, vidé par un ShmRingCollector vers un fichier
+   *
+   */
+  class ShmTarget : public Target {
+  private:
+    std::string m_ring;
+    tscl::Logger m_output;
+    tscl::ShmRingLogHandler *m_handler = nullptr;
+    size_t m_dropped = 0;
+    std::atomic<bool> m_stop{false};
+    std::thread m_collector;
+
+    void collect() {
+      tscl::ShmRingCollector collector(m_output);
+      collector.attach(m_ring);
+
+      while (true) {
+        bool stop = m_stop.load(std::memory_order_acquire);
+        if (collector.poll() == 0) {
+          if (stop) break;
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+      }
+    }
+
+  public:
+    ShmTarget(std::string path, std::string ring) : Target(std::move(path)), m_ring(std::move(ring)) {}
+
+    ~ShmTarget() override { close(); }
+
+    bool install(tscl::Logger &logger) override {
+      tscl::ShmRing::unlink(m_ring);
+      m_output.addHandler<tscl::StreamLogHandler>("output", m_path).stamped(true);
+
+      try {
+        m_handler = &logger.addHandler<tscl::ShmRingLogHandler>("stress", m_ring, 16384, 1024);
+      } catch (std::exception const &) { return false; }
+
+      m_handler->stamped(true);
+      m_collector = std::thread(&ShmTarget::collect, this);
+      return true;
+    }
+
+    void drain() override {
+      if (m_handler) m_dropped = m_handler->dropped();
+      m_stop.store(true, std::memory_order_release);
+      if (m_collector.joinable()) m_collector.join();
+      m_output.shutdown();
+    }
+
+    void close() override {
+      // Le gestionnaire a été détruit avec le Logger
+      m_handler = nullptr;
+      drain();
+      tscl::ShmRing::unlink(m_ring);
+    }
+
+    size_t dropped() override { return m_dropped; }
+  };
+
+  constexpr std::string_view handlers[] = {"stream", "compressed", "console", "socket", "shm"};
+
+  std::unique_ptr<Target> makeTarget(std::string const &handler, std::string const &dir) {
+    std::string base = dir + "/tscl-stress-" + std::to_string(getpid()) + '-' + handler;
+
+    if (handler == "stream") return std::make_unique<StreamTarget>(base + ".log", false);
+    if (handler == "compressed") return std::make_unique<StreamTarget>(base + ".lz4", true);
+    if (handler == "console") return std::make_unique<ConsoleTarget>(base + ".log");
+    if (handler == "socket") return std::make_unique<SocketTarget>(base + ".log", base + ".sock");
+    if (handler == "shm") return std::make_unique<ShmTarget>(base + ".log", "/tscl-stress-" + std::to_string(getpid()));
+    return nullptr;
+  }
+
+  // ==================================================================
+  // ===                         Charge                             ===
+  // ==================================================================
+
+  /**
+   * @brief Logs d'un thread producteur, générés avant le test pour ne pas mesurer le générateur aléatoire
+   *
+   */
+  struct Plan {
+    std::vector<uint32_t> sizes;
+    std::vector<tscl::Log::log_level> levels;
+    uint64_t bytes = 0;
+  };
+
+  Plan makePlan(Options const &opt, size_t thread) {
+    std::mt19937_64 rng(opt.seed * 1000003 + thread);
+    std::discrete_distribution<int> level(opt.levels.weights.begin(), opt.levels.weights.end());
+
+    Plan res;
+    res.sizes.reserve(opt.records);
+    res.levels.reserve(opt.records);
+
+    for (size_t i = 0; i < opt.records; i++) {
+      res.sizes.push_back(opt.sizes(rng));
+      res.levels.push_back(tscl::Log::log_level(level(rng)));
+      res.bytes += res.sizes.back();
+    }
+
+    return res;
+  }
+
+  void produce(tscl::Logger &logger, Plan const &plan, size_t thread, bool async, Burst burst,
+               std::atomic<bool> &go, std::vector<uint32_t> &latencies) {
+    static std::string const payload(max_payload, 'x');
+
+    std::string message;
+    message.reserve(max_payload + 32);
+    latencies.reserve(plan.sizes.size());
+
+    go.wait(false, std::memory_order_acquire);
+
+    for (size_t i = 0; i < plan.sizes.size(); i++) {
+      message.assign(marker);
+      message += std::to_string(thread);
+      message += ':';
+      message += std::to_string(i);
+      message += ' ';
+      message.append(payload, 0, plan.sizes[i]);
+
+      uint64_t begin = monotonicNow();
+      if (async) logger.logAsync(message, plan.levels[i]);
+      else
+        logger(message, plan.levels[i]);
+      latencies.push_back(uint32_t(std::min<uint64_t>(monotonicNow() - begin, UINT32_MAX)));
+
+      if (burst.size and (i + 1) % burst.size == 0) std::this_thread::sleep_for(burst.pause);
+    }
+  }
+
+  struct Result {
+    size_t records = 0;
+    uint64_t bytes = 0;
+    uint64_t produce_time = 0;
+    uint64_t total_time = 0;
+    std::vector<uint32_t> latencies;
+    tscl::LockProfile lock;
+    size_t received = 0;
+    size_t lost = 0;
+    size_t duplicates = 0;
+    size_t dropped = 0;
+    size_t sequenced = 0;
+    uint64_t sequence_gaps = 0;
+    size_t sequence_duplicates = 0;
+  };
+
+  /**
+   * @brief Relit la sortie et compte les logs manquants de chaque producteur
+   *
+   */
+  void check(Target &target, size_t threads, Result &res) {
+    std::vector<tscl::SequenceChecker> producers(threads);
+    tscl::SequenceChecker stamps;
+
+    target.read([&](std::string_view line) {
+      size_t pos = line.find(marker);
+      if (pos == std::string_view::npos) return;
+
+      // Seules les lignes des producteurs sont vérifiées, pas les messages internes du Logger
+      if (auto stamp = tscl::LogStamp::parse(line)) stamps.add(*stamp);
+
+      line.remove_prefix(pos + marker.size());
+      size_t colon = line.find(':');
+      size_t space = line.find(' ');
+      if (colon == std::string_view::npos or space == std::string_view::npos) return;
+
+      auto thread = parseNumber<size_t>(line.substr(0, colon));
+      auto index = parseNumber<uint64_t>(line.substr(colon + 1, space - colon - 1));
+      if (thread and index and *thread < threads) producers[*thread].add(*index + 1);
+    });
+
+    for (auto &producer : producers) {
+      size_t duplicates = producer.duplicates();
+      res.received += producer.size();
+      res.duplicates += duplicates;
+      res.lost += res.records / threads - (producer.size() - duplicates);
+    }
+
+    res.sequenced = stamps.size();
+    res.sequence_duplicates = stamps.duplicates();
+    for (auto const &gap : stamps.gaps()) res.sequence_gaps += gap.last - gap.first + 1;
+  }
+
+  std::optional<Result> run(Options const &opt, std::string const &dir, std::string const &handler, bool async,
+                            size_t threads) {
+    auto target = makeTarget(handler, dir);
+    if (opt.keep) target->keep();
+
+    Result res;
+    res.records = threads * opt.records;
+
+    std::vector<Plan> plans;
+    for (size_t i = 0; i < threads; i++) {
+      plans.push_back(makePlan(opt, i));
+      res.bytes += plans.back().bytes;
+    }
+
+    {
+      tscl::Logger logger;
+      if (not target->install(logger)) {
+        std::cerr << "Cannot set up the " << handler << " handler in " << dir << '\n';
+        return std::nullopt;
+      }
+
+      // Les threads de fond sont démarrés avant la mesure
+      if (async) logger.flush();
+
+      std::atomic<bool> go(false);
+      std::vector<std::vector<uint32_t>> latencies(threads);
+      std::vector<std::thread> producers;
+
+      for (size_t i = 0; i < threads; i++)
+        producers.emplace_back(produce, std::ref(logger), std::cref(plans[i]), i, async, opt.burst, std::ref(go),
+                               std::ref(latencies[i]));
+
+      logger.resetLockProfile();
+      logger.lockProfiling(opt.profile_lock);
+
+      uint64_t begin = monotonicNow();
+      go.store(true, std::memory_order_release);
+      go.notify_all();
+
+      for (auto &producer : producers) producer.join();
+      res.produce_time = monotonicNow() - begin;
+
+      logger.shutdown(std::chrono::seconds(60));
+      target->drain();
+      res.total_time = monotonicNow() - begin;
+
+      logger.lockProfiling(false);
+      res.lock = logger.lockProfile();
+      res.dropped = target->dropped();
+
+      for (auto &samples : latencies) res.latencies.insert(res.latencies.end(), samples.begin(), samples.end());
+    }
+
+    target->close();
+    check(*target, threads, res);
+    return res;
+  }
+
+  // ==================================================================
+  // ===                         Rapport                            ===
+  // ==================================================================
+
+  std::string duration(uint64_t ns) {
+    char buffer[32];
+    if (ns < 10000) std::snprintf(buffer, sizeof(buffer), "%lluns", static_cast<unsigned long long>(ns));
+    else if (ns < 10000000)
+      std::snprintf(buffer, sizeof(buffer), "%.1fus", ns / 1e3);
+    else
+      std::snprintf(buffer, sizeof(buffer), "%.1fms", ns / 1e6);
+    return buffer;
+  }
+
+  void report(Result &res) {
+    std::sort(res.latencies.begin(), res.latencies.end());
+    auto at = [&](double q) {
+      return duration(res.latencies[std::min(res.latencies.size() - 1, size_t(q * res.latencies.size()))]);
+    };
+
+    std::printf("  throughput  produce %.0f rec/s, end-to-end %.0f rec/s (%.1f MB/s)\n",
+                res.records / (res.produce_time / 1e9), res.records / (res.total_time / 1e9),
+                res.bytes / (res.total_time / 1e3));
+    std::printf("  latency     p50 %s  p99 %s  p99.9 %s  max %s\n", at(0.5).c_str(), at(0.99).c_str(),
+                at(0.999).c_str(), duration(res.latencies.back()).c_str());
+    std::printf("  main lock   %s\n", res.lock.format().c_str());
+    std::printf("  check       %zu received, %zu lost, %zu duplicated, %zu dropped by the handler\n", res.received,
+                res.lost, res.duplicates, res.dropped);
+    std::printf("  sequence    %zu numbers, %llu missing, %zu duplicated\n", res.sequenced,
+                static_cast<unsigned long long>(res.sequence_gaps), res.sequence_duplicates);
+  }
+
+  void usage(char const *name) {
+    std::cerr << "Usage : " << name
+              << " [-t threads] [-n records] [-s fixed:N|uniform:MIN-MAX|pareto:MIN] [-l level:weight,...]\n"
+                 "       [-b records/pause] [-h stream,compressed,console,socket,shm] [-d dir]... [-m sync,async]\n"
+                 "       [-r seed] [-P] [-k]\n";
+  }
+}   // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    bool ok = true;
+
+    if (arg == "-P") opt.profile_lock = false;
+    else if (arg == "-k")
+      opt.keep = true;
+    else if (i + 1 == argc)
+      ok = false;
+    else {
+      std::string_view value = argv[++i];
+
+      if (arg == "-t") {
+        opt.threads.clear();
+        for (auto str : split(value, ',')) {
+          auto count = parseNumber<size_t>(str);
+          if (not count or not *count) ok = false;
+          else
+            opt.threads.push_back(*count);
+        }
+      } else if (arg == "-n") {
+        auto records = parseNumber<size_t>(value);
+        ok = records and *records;
+        if (ok) opt.records = *records;
+      } else if (arg == "-s") {
+        auto sizes = SizeDistribution::parse(value);
+        ok = sizes.has_value();
+        if (ok) opt.sizes = *sizes;
+      } else if (arg == "-l") {
+        auto levels = LevelMix::parse(value);
+        ok = levels.has_value();
+        if (ok) opt.levels = *levels;
+      } else if (arg == "-b") {
+        auto burst = Burst::parse(value);
+        ok = burst.has_value();
+        if (ok) opt.burst = *burst;
+      } else if (arg == "-h") {
+        opt.handlers.clear();
+        for (auto str : split(value, ',')) opt.handlers.emplace_back(str);
+        ok = std::all_of(opt.handlers.begin(), opt.handlers.end(), [](std::string const &handler) {
+          return std::find(std::begin(handlers), std::end(handlers), handler) != std::end(handlers);
+        });
+      } else if (arg == "-d")
+        opt.dirs.emplace_back(value);
+      else if (arg == "-m") {
+        opt.async.clear();
+        for (auto str : split(value, ',')) {
+          if (str == "sync" or str == "async") opt.async.push_back(str == "async");
+          else
+            ok = false;
+        }
+      } else if (arg == "-r") {
+        auto seed = parseNumber<uint64_t>(value);
+        ok = seed.has_value();
+        if (ok) opt.seed = *seed;
+      } else
+        ok = false;
+    }
+
+    if (not ok) {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (opt.handlers.empty()) opt.handlers.assign(std::begin(handlers), std::end(handlers));
+  if (opt.dirs.empty()) opt.dirs = {"/dev/shm", "/var/tmp"};
+
+  // Un dossier inutilisable ferait passer tout les logs pour perdus
+  for (auto const &dir : opt.dirs) {
+    if (access(dir.c_str(), W_OK | X_OK) != 0) {
+      std::cerr << "Cannot write to directory " << dir << '\n';
+      return 1;
+    }
+  }
+
+  bool lossless = true;
+
+  for (auto const &dir : opt.dirs) {
+    for (auto const &handler : opt.handlers) {
+      for (bool async : opt.async) {
+        for (size_t threads : opt.threads) {
+          std::printf("[%s %s %s, %zu threads] %zu records\n", dir.c_str(), handler.c_str(), async ? "async" : "sync",
+                      threads, threads * opt.records);
+          std::fflush(stdout);
+
+          auto res = run(opt, dir, handler, async, threads);
+          if (not res) return 1;
+
+          report(*res);
+          std::fflush(stdout);
+          lossless = lossless and res->lost == 0 and res->duplicates == 0;
+        }
+      }
+    }
+  }
+
+  return lossless ? 0 : 2;
+}
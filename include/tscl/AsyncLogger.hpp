@@ -0,0 +1,339 @@
+#pragma once
+#include "BoundedQueue.hpp"
+#include "Logger.hpp"
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace tscl {
+
+  /**
+   * @brief Fonction chargée de reprendre une coroutine, typiquement en la postant sur l'ordonnanceur
+   * de l'appelant. Sans resumer, les coroutines sont reprises directement par le thread du backend
+   *
+   */
+  using Resumer = std::function<void(std::coroutine_handle<>)>;
+
+  /**
+   * @brief Thread de fond d'un Logger, traitant les logs envoyés par logAsync() ainsi que les demandes
+   * de flush et de retrait de gestionnaire
+   *
+   * Les logs transitent par une file bornée sans verrou. Lorsque la file est pleine, la coroutine
+   * émettrice est suspendue et son log est mis de coté, puis elle est reprise une fois le log traité
+   *
+   */
+  class AsyncBackend {
+  public:
+    /**
+     * @brief Log en attente de traitement, dont le message est déja construit. La pile d'appels
+     * éventuelle n'est symbolisée que par le backend
+     *
+     */
+    struct Record {
+      Log::log_level level = Log::Trace;
+      LogCategory const *category = nullptr;
+      long error_code = errors::ERR_NONE;
+      LogStamp stamp;
+      LogContext context;
+      LogBuffer origin;
+      LogBuffer message;
+      StackTrace trace;
+    };
+
+    /**
+     * @brief Notification de fin d'une opération, pour une coroutine ou un appelant bloqué
+     *
+     * Le drapeau d'un appelant bloqué est partagé avec la notification : l'appelant peut le voir
+     * passer a vrai et retourner avant que le backend n'ait fini de le notifier
+     *
+     */
+    struct Completion {
+      std::coroutine_handle<> handle;
+      Resumer resumer;
+      std::shared_ptr<std::atomic<bool>> done;
+
+      void complete();
+
+      /**
+       * @brief Alloue un drapeau a attendre
+       *
+       * @return std::shared_ptr<std::atomic<bool>> Le drapeau, nullptr si l'allocation a échoué
+       */
+      static std::shared_ptr<std::atomic<bool>> makeFlag() noexcept;
+    };
+
+  private:
+    /**
+     * @brief Demande adressée au backend
+     *
+     */
+    struct Request {
+      enum kind_t { Flush, RemoveHandler } kind;
+      std::string name;
+      Completion completion;
+    };
+
+    /**
+     * @brief Log n'ayant pas pu etre ajouté a la file, et coroutine a reprendre une fois traité
+     *
+     */
+    struct Overflow {
+      Record record;
+      std::optional<Completion> completion;
+    };
+
+    Logger &m_logger;
+    BoundedQueue<Record> m_queue;
+
+    /**
+     * @brief Protege les demandes, les logs en débordement et le resumer par défaut
+     *
+     */
+    std::mutex m_mutex;
+    std::vector<Request> m_requests;
+    std::deque<Overflow> m_overflow;
+    Resumer m_resumer;
+
+    /**
+     * @brief Vrai tant que des logs en débordement n'ont pas été traités. Les logs suivants sont
+     * alors eux aussi mis de coté, pour qu'un producteur ne double pas ses propres logs par la file
+     *
+     */
+    std::atomic<bool> m_deferring;
+    bool m_stop;
+
+    /**
+     * @brief Compteur sur lequel le backend s'endort, incrémenté pour le réveiller
+     *
+     */
+    std::atomic<uint32_t> m_signal;
+
+    /**
+     * @brief Vrai lorsque le backend est endormi ou sur le point de l'etre. Le premier producteur a
+     * le remettre a faux réveille le backend, les suivants n'ont aucun appel systeme a faire
+     *
+     */
+    std::atomic<bool> m_sleeping;
+
+    /**
+     * @brief Paramètres de la configuration modifiables pendant l'exécution
+     *
+     */
+    std::atomic<BackendConfig::wait_t> m_wait;
+    std::atomic<uint32_t> m_spin;
+    std::atomic<uint32_t> m_yield;
+    std::atomic<size_t> m_batch;
+
+    /**
+     * @brief Durée actuelle de l'attente active pour Park, ajustée a chaque attente
+     *
+     */
+    uint32_t m_spin_budget;
+
+    std::thread m_thread;
+
+    void run();
+
+    /**
+     * @brief Attend un nouveau log ou une nouvelle demande, selon la stratégie configurée
+     *
+     * @param signal Valeur de m_signal relevée avant de vider la file
+     */
+    void idle(uint32_t signal);
+
+    /**
+     * @brief Traite les logs de la file
+     *
+     * @param limit Nombre maximum de logs a traiter
+     * @return size_t Le nombre de logs traités
+     */
+    size_t drain(size_t limit);
+
+    /**
+     * @brief Transmet un log aux gestionnaires du Logger
+     *
+     */
+    void dispatch(Record &record);
+
+    /**
+     * @brief Réveille le backend s'il est endormi
+     *
+     * @param force Réveille le backend meme s'il n'est pas marqué comme endormi
+     */
+    void wake(bool force = false);
+
+  public:
+    AsyncBackend(Logger &logger, BackendConfig const &config = {});
+
+    /**
+     * @brief Traite les logs et demandes en attente, puis arrete le thread
+     *
+     */
+    ~AsyncBackend();
+
+    /**
+     * @brief Applique une configuration au thread déja démarré. La capacité de la file est ignorée
+     *
+     * @param config La configuration
+     * @return true Si l'affinité et le nom du thread ont pu etre appliqués
+     */
+    bool configure(BackendConfig const &config);
+
+    /**
+     * @brief Construit un Record a partir d'un log, en capturant son contexte et son message
+     *
+     */
+    static Record makeRecord(Log const &log);
+
+    /**
+     * @brief Ajoute un log a la file sans bloquer
+     *
+     * @param record Le log, déplacé uniquement en cas de succes
+     * @return true Si le log a été ajouté, false si la file est pleine ou que des logs sont en
+     * débordement
+     */
+    bool tryPush(Record &record);
+
+    /**
+     * @brief Ajoute un log a la file, ou le met de coté si elle est pleine
+     *
+     * @param record Le log
+     * @param completion Notification a déclencher une fois le log traité, si le log a été mis de coté
+     * @return true Si le log a été mis de coté, et que la notification sera donc déclenchée
+     */
+    bool pushOrDefer(Record &record, std::optional<Completion> completion);
+
+    /**
+     * @brief Demande un flush de tout les gestionnaires, une fois les logs déja envoyés traités
+     *
+     */
+    void flush(Completion completion);
+
+    /**
+     * @brief Demande le retrait d'un gestionnaire, une fois les logs déja envoyés traités
+     *
+     */
+    void removeHandler(std::string name, Completion completion);
+
+    /**
+     * @brief Définit le resumer utilisé par défaut pour reprendre les coroutines
+     *
+     */
+    void resumer(Resumer resumer);
+
+    /**
+     * @brief Retourne une copie du resumer par défaut
+     *
+     */
+    Resumer resumer();
+
+    /**
+     * @brief Indique si l'appelant est le thread du backend, qui ne doit pas attendre ses propres demandes
+     *
+     */
+    bool onBackendThread() const noexcept;
+  };
+
+  /**
+   * @brief Opération retournée par Logger::logAsync(). Le log est envoyé des la création de
+   * l'opération, co_await ne suspend la coroutine que si la file du backend est pleine
+   *
+   * Si l'opération est détruite sans etre attendue, le log est tout de meme traité
+   *
+   */
+  class LogOperation {
+  private:
+    AsyncBackend *m_backend;
+    std::optional<AsyncBackend::Record> m_pending;
+    std::optional<Resumer> m_resumer;
+
+  public:
+    LogOperation(AsyncBackend *backend, std::optional<AsyncBackend::Record> pending)
+        : m_backend(backend), m_pending(std::move(pending)) {}
+
+    LogOperation(LogOperation &&other) noexcept
+        : m_backend(other.m_backend), m_pending(std::exchange(other.m_pending, std::nullopt)),
+          m_resumer(std::move(other.m_resumer)) {}
+
+    LogOperation &operator=(LogOperation &&) = delete;
+
+    ~LogOperation() {
+      if (m_pending) m_backend->pushOrDefer(*m_pending, std::nullopt);
+    }
+
+    /**
+     * @brief Reprend la coroutine a l'aide d'un resumer spécifique
+     *
+     */
+    LogOperation &&via(Resumer resumer) && {
+      m_resumer = std::move(resumer);
+      return std::move(*this);
+    }
+
+    bool await_ready() const noexcept { return not m_pending; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      // Une fois la coroutine confiée au backend, elle peut etre reprise et l'opération détruite
+      // avant le retour de pushOrDefer : this n'est plus utilisé ensuite
+      AsyncBackend *backend = m_backend;
+      AsyncBackend::Record record = std::move(*m_pending);
+      m_pending.reset();
+
+      AsyncBackend::Completion completion{handle, m_resumer ? std::move(*m_resumer) : backend->resumer()};
+      return backend->pushOrDefer(record, std::move(completion));
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  /**
+   * @brief Opération asynchrone déclenchée a l'attente : flush ou retrait d'un gestionnaire. La
+   * coroutine est reprise une fois tout les logs envoyés auparavant traités
+   *
+   */
+  class [[nodiscard]] BackendOperation {
+  private:
+    AsyncBackend *m_backend;
+    std::optional<std::string> m_handler;
+    std::optional<Resumer> m_resumer;
+
+  public:
+    /**
+     * @brief Construit l'opération
+     *
+     * @param backend Backend du logger
+     * @param handler Nom du gestionnaire a retirer, std::nullopt pour un flush
+     */
+    BackendOperation(AsyncBackend *backend, std::optional<std::string> handler)
+        : m_backend(backend), m_handler(std::move(handler)) {}
+
+    /**
+     * @brief Reprend la coroutine a l'aide d'un resumer spécifique
+     *
+     */
+    BackendOperation &&via(Resumer resumer) && {
+      m_resumer = std::move(resumer);
+      return std::move(*this);
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+      AsyncBackend::Completion completion{handle, m_resumer ? *m_resumer : m_backend->resumer()};
+
+      if (m_handler) m_backend->removeHandler(std::move(*m_handler), std::move(completion));
+      else
+        m_backend->flush(std::move(completion));
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  template<LazyMessage TFunc>
+  LogOperation Logger::logAsync(TFunc &&func, Log::log_level level) {
+    return logAsync(LazyLog<std::decay_t<TFunc>>(std::forward<TFunc>(func), level));
+  }
+}   // namespace tscl
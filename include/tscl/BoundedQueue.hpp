@@ -0,0 +1,108 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace tscl {
+
+  /**
+   * @brief File bornée sans verrou, a plusieurs producteurs et un seul consommateur
+   *
+   * Chaque emplacement porte un numéro de séquence indiquant s'il est libre ou publié. Un producteur
+   * réserve une position avec un compare-and-swap sur l'index d'écriture, puis publie l'élément en
+   * mettant a jour la séquence de l'emplacement
+   *
+   * @tparam T Type des éléments, doit etre constructible par défaut et assignable par mouvement
+   */
+  template<typename T>
+  class BoundedQueue {
+  private:
+    struct Cell {
+      std::atomic<size_t> sequence;
+      T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+
+    alignas(64) std::atomic<size_t> m_write_index;
+    alignas(64) size_t m_read_index;
+
+  public:
+    /**
+     * @brief Construit la file
+     *
+     * @param capacity Nombre d'emplacements, arrondi a la puissance de deux supérieure
+     */
+    explicit BoundedQueue(size_t capacity)
+        : m_cells(new Cell[std::bit_ceil(std::max<size_t>(capacity, 2))]),
+          m_mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), m_write_index(0), m_read_index(0) {
+      for (size_t i = 0; i <= m_mask; i++) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(BoundedQueue const &) = delete;
+    BoundedQueue &operator=(BoundedQueue const &) = delete;
+
+    size_t capacity() const noexcept { return m_mask + 1; }
+
+    /**
+     * @brief Ajoute un élément, peut etre appelé depuis n'importe quel thread
+     *
+     * @param value L'élément, déplacé uniquement en cas de succes
+     * @return true Si l'élément a été ajouté, false si la file est pleine
+     */
+    bool tryPush(T &value) noexcept {
+      size_t pos = m_write_index.load(std::memory_order_relaxed);
+      Cell *cell;
+
+      while (true) {
+        cell = &m_cells[pos & m_mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+
+        if (diff == 0) {
+          if (m_write_index.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+          return false;
+        } else {
+          pos = m_write_index.load(std::memory_order_relaxed);
+        }
+      }
+
+      cell->value = std::move(value);
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Retourne l'élément en tete de file sans le retirer. Réservé au consommateur
+     *
+     * @return T* L'élément, ou nullptr si la file est vide
+     */
+    T *front() noexcept {
+      Cell &cell = m_cells[m_read_index & m_mask];
+      if (cell.sequence.load(std::memory_order_acquire) != m_read_index + 1) return nullptr;
+      return &cell.value;
+    }
+
+    /**
+     * @brief Libere l'élément en tete de file. Réservé au consommateur
+     *
+     */
+    void pop() noexcept {
+      Cell &cell = m_cells[m_read_index & m_mask];
+      cell.sequence.store(m_read_index + m_mask + 1, std::memory_order_release);
+      m_read_index++;
+    }
+
+    /**
+     * @brief Indique si la file est vide. Réservé au consommateur
+     *
+     */
+    bool empty() noexcept { return front() == nullptr; }
+  };
+}   // namespace tscl
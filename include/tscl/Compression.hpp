@@ -0,0 +1,218 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tscl {
+
+  /**
+   * @brief Compression par blocs au format LZ4, sans dépendance
+   *
+   */
+  namespace lz {
+    /**
+     * @brief Taille maximum d'un bloc compressé
+     *
+     * @param size Taille des données a compresser
+     */
+    constexpr size_t compressBound(size_t size) noexcept { return size + size / 255 + 16; }
+
+    /**
+     * @brief Compresse un bloc
+     *
+     * @param src Données a compresser, au plus 2 Go
+     * @param dst Destination, d'au moins compressBound(src.size()) octets
+     * @return size_t Taille des données compressées
+     */
+    size_t compress(std::span<char const> src, char *dst) noexcept;
+
+    /**
+     * @brief Décompresse un bloc, en vérifiant qu'il ne sort jamais de la destination
+     *
+     * @param src Données compressées
+     * @param dst Destination, de la taille exacte des données décompressées
+     * @return true Si le bloc est valide et remplit exactement la destination
+     */
+    bool decompress(std::span<char const> src, std::span<char> dst) noexcept;
+  }   // namespace lz
+
+  /**
+   * @brief Format des fichiers compressés : un en-tete, puis une suite de blocs indépendants
+   *
+   * Chaque bloc est précédé de sa taille et d'une somme de controle, un fichier tronqué reste donc
+   * lisible jusqu'au dernier bloc complet
+   *
+   */
+  namespace frame {
+    constexpr char magic[7] = {'t', 's', 'c', 'l', 'l', 'z', '4'};
+    constexpr uint8_t version = 1;
+
+    /**
+     * @brief Bit de compressed_size indiquant un bloc stocké sans compression
+     *
+     */
+    constexpr uint32_t uncompressed_flag = 0x80000000;
+
+    struct FileHeader {
+      char magic[7];
+      uint8_t version;
+      uint32_t block_size;
+      uint32_t reserved;
+    };
+
+    struct BlockHeader {
+      uint32_t compressed_size;
+      uint32_t raw_size;
+
+      /**
+       * @brief Somme FNV-1a des données décompressées
+       *
+       */
+      uint32_t checksum;
+    };
+
+    static_assert(sizeof(FileHeader) == 16 and sizeof(BlockHeader) == 12);
+
+    uint32_t checksum(std::span<char const> data) noexcept;
+  }   // namespace frame
+
+  /**
+   * @brief Tampon de flux écrivant un fichier compressé
+   *
+   * Les écritures sont accumulées dans un bloc, compressé puis écrit par un thread dédié une fois
+   * plein. Un bloc partiel est écrit au bout de max_delay, ou lors d'un appel a flush(). La
+   * synchronisation du flux (std::flush) ne coupe pas le bloc en cours
+   *
+   */
+  class CompressedStreamBuf : public std::streambuf {
+  public:
+    static constexpr size_t default_block_size = 1 << 20;
+
+    /**
+     * @brief Nombre de blocs pleins en attente au dela duquel les écrivains attendent le thread
+     *
+     */
+    static constexpr size_t max_pending = 4;
+
+    /**
+     * @brief Délai maximum avant l'écriture d'un bloc partiel
+     *
+     */
+    static constexpr std::chrono::milliseconds max_delay{1000};
+
+  private:
+    std::ofstream m_file;
+    size_t m_block_size;
+
+    /**
+     * @brief Protege le bloc en cours et la file des blocs a compresser
+     *
+     */
+    std::mutex m_mutex;
+    std::condition_variable m_pending_cv;
+    std::condition_variable m_done_cv;
+
+    std::string m_current;
+    std::chrono::steady_clock::time_point m_current_since;
+    std::deque<std::string> m_pending;
+
+    /**
+     * @brief Blocs déja écrits, réutilisés pour ne pas allouer a chaque bloc
+     *
+     */
+    std::vector<std::string> m_free;
+
+    /**
+     * @brief Nombre de blocs pris par le thread et pas encore écrits
+     *
+     */
+    size_t m_writing;
+    bool m_stop;
+
+    std::thread m_thread;
+
+    void run();
+
+    /**
+     * @brief Place le bloc en cours dans la file, m_mutex doit etre verrouillé
+     *
+     */
+    void submit();
+
+    /**
+     * @brief Compresse et écrit un bloc
+     *
+     */
+    void writeBlock(std::string const &block, std::vector<char> &buffer);
+
+  protected:
+    virtual std::streamsize xsputn(char const *s, std::streamsize n) override;
+    virtual int_type overflow(int_type c) override;
+
+  public:
+    /**
+     * @brief Ouvre le fichier, en écrasant son contenu
+     *
+     * @param path Chemin du fichier
+     * @param block_size Taille des blocs avant compression
+     */
+    CompressedStreamBuf(std::string const &path, size_t block_size = default_block_size);
+
+    /**
+     * @brief Ecrit le bloc en cours puis ferme le fichier
+     *
+     */
+    ~CompressedStreamBuf();
+
+    bool isOpen() const { return m_file.is_open(); }
+
+    /**
+     * @brief Ecrit le bloc en cours, et attend que tout les blocs soient sur le disque
+     *
+     */
+    void flush();
+  };
+
+  /**
+   * @brief Lecteur de fichiers compressés, bloc par bloc
+   *
+   */
+  class CompressedReader {
+  public:
+    enum status_t { Ok, End, Truncated, Corrupted, InvalidHeader };
+
+  private:
+    std::istream &m_in;
+    std::vector<char> m_compressed;
+    std::vector<char> m_block;
+    status_t m_status;
+
+  public:
+    /**
+     * @brief Lit l'en-tete du fichier
+     *
+     * @param in Flux ouvert en mode binaire
+     */
+    explicit CompressedReader(std::istream &in);
+
+    /**
+     * @brief Décompresse le bloc suivant
+     *
+     * @return std::optional<std::span<char const>> Le bloc, valide jusqu'a l'appel suivant, ou
+     * std::nullopt a la fin du fichier ou en cas d'erreur (voir status())
+     */
+    std::optional<std::span<char const>> next();
+
+    status_t status() const noexcept { return m_status; }
+  };
+}   // namespace tscl
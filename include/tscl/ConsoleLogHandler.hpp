@@ -0,0 +1,49 @@
+#pragma once
+#include "Logger.hpp"
+
+namespace tscl {
+
+  /**
+   * @brief Gestionnaire écrivant les logs sur la sortie standard ou d'erreur
+   *
+   * Chaque log est écrit par un seul appel a writev sur le descripteur, sans passer par std::cout :
+   * aucune copie de la couleur ni de la ligne complete, et un log de moins de PIPE_BUF octets arrive
+   * d'un bloc lorsque la sortie est un pipe lu par un autre processus. Les couleurs ne sont
+   * utilisées par défaut que si la sortie est un terminal
+   *
+   */
+  class ConsoleLogHandler : public LogHandler {
+  public:
+    enum class stream_t { Stdout, Stderr };
+
+    enum class color_t {
+      /**
+       * @brief Couleurs si la sortie est un terminal, que TERM ne vaut pas "dumb" et que NO_COLOR
+       * n'est pas défini
+       *
+       */
+      Auto,
+      Always,
+      Never
+    };
+
+  private:
+    int m_fd;
+    bool m_color;
+
+  public:
+    /**
+     * @param stream Sortie a utiliser
+     * @param color Utilisation des couleurs
+     */
+    explicit ConsoleLogHandler(stream_t stream = stream_t::Stdout, color_t color = color_t::Auto);
+
+    /**
+     * @brief Indique si les logs sont colorés
+     *
+     */
+    bool colored() const noexcept { return m_color; }
+
+    virtual void log(Log const &log, std::string const &message) override;
+  };
+}   // namespace tscl
@@ -0,0 +1,130 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace tscl {
+
+  /**
+   * @brief Chaine de caracteres destinée au contenu des logs
+   *
+   * Les messages courts sont stockés directement dans l'objet. Les messages plus longs sont
+   * stockés dans des blocs de taille fixe, recyclés par un cache propre a chaque thread puis par une
+   * réserve commune : une fois les caches remplis, construire un log n'appelle plus malloc. Seuls
+   * les messages dépassant le plus grand bloc sont alloués directement
+   *
+   */
+  class LogBuffer {
+  public:
+    /**
+     * @brief Nombre de caracteres stockés dans l'objet, sans allocation
+     *
+     */
+    static constexpr size_t inline_capacity = 111;
+
+    /**
+     * @brief Tailles des blocs recyclés
+     *
+     */
+    static constexpr size_t chunk_sizes[] = {256, 1024, 4096, 16384};
+
+  private:
+    /**
+     * @brief Début de la chaine, pointe sur m_inline ou sur un bloc
+     *
+     */
+    char *m_data;
+
+    uint32_t m_size;
+
+    /**
+     * @brief Nombre de caracteres utilisables, sans le zéro final
+     *
+     */
+    uint32_t m_capacity;
+
+    char m_inline[inline_capacity + 1];
+
+    bool isInline() const noexcept { return m_data == m_inline; }
+
+    /**
+     * @brief Alloue un bloc pouvant contenir au moins size caracteres et le zéro final
+     *
+     * @param size Nombre de caracteres
+     * @param capacity Recoit le nombre de caracteres utilisables
+     * @return char* Le bloc
+     */
+    static char *allocate(size_t size, uint32_t &capacity);
+
+    /**
+     * @brief Rend un bloc au cache du thread appelant
+     *
+     * @param data Le bloc
+     * @param capacity Sa capacité, telle que retournée par allocate()
+     */
+    static void deallocate(char *data, uint32_t capacity) noexcept;
+
+    /**
+     * @brief Agrandit le stockage en conservant son contenu
+     *
+     * @param size Nombre de caracteres a pouvoir stocker
+     */
+    void reserve(size_t size);
+
+  public:
+    LogBuffer() noexcept : m_data(m_inline), m_size(0), m_capacity(inline_capacity) { m_inline[0] = '\0'; }
+
+    LogBuffer(std::string_view str) : LogBuffer() { append(str); }
+
+    LogBuffer(LogBuffer const &other) : LogBuffer() { append(other.view()); }
+
+    LogBuffer(LogBuffer &&other) noexcept;
+
+    LogBuffer &operator=(LogBuffer const &other);
+
+    LogBuffer &operator=(LogBuffer &&other) noexcept;
+
+    ~LogBuffer() {
+      if (not isInline()) deallocate(m_data, m_capacity);
+    }
+
+    /**
+     * @brief Ajoute des caracteres a la fin de la chaine
+     *
+     * @param str Caracteres a ajouter
+     * @return LogBuffer&
+     */
+    LogBuffer &append(std::string_view str);
+
+    LogBuffer &operator+=(std::string_view str) { return append(str); }
+
+    LogBuffer &operator+=(char c) { return append(std::string_view(&c, 1)); }
+
+    /**
+     * @brief Remplace le contenu, en conservant le stockage actuel si possible
+     *
+     * @param str Nouveau contenu
+     * @return LogBuffer&
+     */
+    LogBuffer &assign(std::string_view str) {
+      clear();
+      return append(str);
+    }
+
+    /**
+     * @brief Vide la chaine sans libérer son stockage
+     *
+     */
+    void clear() noexcept {
+      m_size = 0;
+      m_data[0] = '\0';
+    }
+
+    std::string_view view() const noexcept { return {m_data, m_size}; }
+    operator std::string_view() const noexcept { return view(); }
+    char const *c_str() const noexcept { return m_data; }
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+  };
+}   // namespace tscl
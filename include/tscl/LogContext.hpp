@@ -0,0 +1,206 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace tscl {
+
+  /**
+   * @brief Contexte de logging propre a chaque thread (identifiant de requete, client, ...)
+   *
+   * Les champs sont stockés dans des tableaux de taille fixe, ajouter ou retirer un champ
+   * n'alloue donc jamais de mémoire. Le contexte est associé a chaque log lors de sa construction,
+   * et n'est formaté que si le log est réellement affiché par un gestionnaire
+   *
+   */
+  class LogContext {
+  public:
+    /**
+     * @brief Nombre maximum de champs, les champs supplémentaires sont ignorés
+     *
+     */
+    static constexpr size_t max_fields = 8;
+
+    /**
+     * @brief Taille maximum d'une clé, les clés plus longues sont tronquées
+     *
+     */
+    static constexpr size_t max_key_size = 23;
+
+    /**
+     * @brief Taille maximum d'une valeur, les valeurs plus longues sont tronquées
+     *
+     */
+    static constexpr size_t max_value_size = 55;
+
+    /**
+     * @brief Un champ clé/valeur du contexte
+     *
+     */
+    struct Field {
+      char key_data[max_key_size] = {};
+      uint8_t key_size = 0;
+      char value_data[max_value_size] = {};
+      uint8_t value_size = 0;
+
+      std::string_view key() const noexcept { return {key_data, key_size}; }
+      std::string_view value() const noexcept { return {value_data, value_size}; }
+    };
+
+    class Scope;
+    class Restore;
+
+  private:
+    /**
+     * @brief Champs actuellement définis
+     *
+     */
+    Field m_fields[max_fields];
+
+    /**
+     * @brief Nombre de champs définis
+     *
+     */
+    size_t m_size;
+
+  public:
+    constexpr LogContext() noexcept : m_fields(), m_size(0) {}
+
+    /**
+     * @brief Seuls les champs définis sont copiés
+     *
+     */
+    LogContext(LogContext const &other) noexcept : m_size(other.m_size) {
+      std::copy_n(other.m_fields, m_size, m_fields);
+    }
+
+    LogContext &operator=(LogContext const &other) noexcept {
+      m_size = other.m_size;
+      std::copy_n(other.m_fields, m_size, m_fields);
+      return *this;
+    }
+
+    /**
+     * @brief Retourne le contexte du thread courant
+     *
+     * @return LogContext&
+     */
+    static LogContext &current() noexcept;
+
+    /**
+     * @brief Capture le contexte du thread courant, pour pouvoir le transmettre a un autre thread
+     *
+     * @return LogContext Une copie du contexte
+     */
+    static LogContext capture() noexcept { return current(); }
+
+    /**
+     * @brief Encapsule un callable de sorte qu'il s'éxecute avec le contexte du thread appelant,
+     * quel que soit le thread qui l'exécute. Utile pour transmettre le contexte a un pool de threads
+     *
+     * @param func Le callable a encapsuler
+     * @return Un callable restaurant le contexte capturé avant d'appeler func
+     */
+    template<typename TFunc>
+    static auto wrap(TFunc &&func) {
+      return [context = capture(), func = std::forward<TFunc>(func)](auto &&...args) mutable {
+        Restore restore(context);
+        return func(std::forward<decltype(args)>(args)...);
+      };
+    }
+
+    /**
+     * @brief Ajoute un champ a la fin du contexte
+     *
+     * @param key Clé du champ
+     * @param value Valeur du champ
+     * @return true Si le champ a été ajouté, false si le contexte est plein
+     */
+    bool push(std::string_view key, std::string_view value) noexcept;
+
+    /**
+     * @brief Retire le dernier champ ajouté
+     *
+     */
+    void pop() noexcept {
+      if (m_size) m_size--;
+    }
+
+    /**
+     * @brief Retourne la valeur associé a une clé, en partant du champ le plus récent
+     *
+     * @param key La clé recherché
+     * @return std::string_view La valeur, vide si la clé est absente
+     */
+    std::string_view find(std::string_view key) const noexcept;
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    Field const *begin() const noexcept { return m_fields; }
+    Field const *end() const noexcept { return m_fields + m_size; }
+
+    /**
+     * @brief Ajoute le contexte formaté, au format " {clé=valeur clé=valeur}", a la fin d'un string
+     *
+     * @param out String de sortie
+     */
+    void render(std::string &out) const;
+  };
+
+  /**
+   * @brief Ajoute un champ au contexte du thread courant pour la durée de vie de l'objet
+   *
+   */
+  class LogContext::Scope {
+  private:
+    /**
+     * @brief Vrai si le champ a pu etre ajouté
+     *
+     */
+    bool m_pushed;
+
+  public:
+    Scope(std::string_view key, std::string_view value) noexcept : m_pushed(current().push(key, value)) {}
+
+    template<std::integral TValue>
+    Scope(std::string_view key, TValue value) noexcept {
+      char buffer[24];
+      auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+      m_pushed = current().push(key, std::string_view(buffer, res.ptr - buffer));
+    }
+
+    Scope(Scope const &) = delete;
+    Scope &operator=(Scope const &) = delete;
+
+    ~Scope() {
+      if (m_pushed) current().pop();
+    }
+  };
+
+  /**
+   * @brief Remplace le contexte du thread courant par un contexte capturé, et restaure le
+   * contexte précédent lors de sa destruction
+   *
+   */
+  class LogContext::Restore {
+  private:
+    /**
+     * @brief Contexte du thread avant la restauration
+     *
+     */
+    LogContext m_previous;
+
+  public:
+    explicit Restore(LogContext const &context) noexcept : m_previous(current()) { current() = context; }
+
+    Restore(Restore const &) = delete;
+    Restore &operator=(Restore const &) = delete;
+
+    ~Restore() { current() = m_previous; }
+  };
+}   // namespace tscl
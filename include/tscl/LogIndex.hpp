@@ -0,0 +1,123 @@
+#pragma once
+#include "Logger.hpp"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace tscl {
+
+  /**
+   * @brief En-tete d'un fichier d'index, suivi d'une suite de LogIndexEntry
+   *
+   */
+  struct LogIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;
+
+    static constexpr char expected_magic[8] = {'t', 's', 'c', 'l', 'i', 'd', 'x', '\0'};
+    static constexpr uint32_t current_version = 1;
+  };
+
+  /**
+   * @brief Entrée d'index décrivant un bloc de logs consécutifs. Le bloc s'étend de offset jusqu'a
+   * l'offset de l'entrée suivante, ou jusqu'a la fin du fichier
+   *
+   */
+  struct LogIndexEntry {
+    /**
+     * @brief Position du premier log du bloc dans le fichier
+     *
+     */
+    uint64_t offset;
+
+    /**
+     * @brief Date de capture du plus ancien log du bloc, et la plus récente de tout les logs écrits
+     * jusqu'a la fin du bloc, en nanosecondes depuis l'epoch. Les logs de threads différents peuvent
+     * etre écrits dans un ordre légerement différent de leur capture : last_timestamp reste ainsi
+     * croissant d'une entrée a l'autre, ce qui permet une recherche dichotomique
+     *
+     */
+    uint64_t first_timestamp, last_timestamp;
+
+    /**
+     * @brief Nombre de logs dans le bloc
+     *
+     */
+    uint32_t count;
+
+    /**
+     * @brief Niveaux présents dans le bloc, le bit n correspondant au niveau n
+     *
+     */
+    uint32_t levels;
+  };
+
+  static_assert(sizeof(LogIndexEntry) == 32);
+
+  /**
+   * @brief Ecrit l'index d'un fichier de logs au fur et a mesure de son écriture
+   *
+   * Une entrée est ajoutée tout les max_records logs, ou lorsque le bloc courant couvre plus de
+   * max_duration
+   *
+   */
+  class LogIndexWriter {
+  private:
+    std::ofstream m_out;
+    size_t m_max_records;
+    std::chrono::nanoseconds m_max_duration;
+
+    /**
+     * @brief Position de la fin du fichier de logs
+     *
+     */
+    uint64_t m_offset;
+
+    /**
+     * @brief Bloc en cours de construction
+     *
+     */
+    LogIndexEntry m_current;
+
+    /**
+     * @brief Date de capture la plus récente parmi les logs enregistrés
+     *
+     */
+    uint64_t m_latest;
+
+  public:
+    /**
+     * @brief Crée le fichier d'index
+     *
+     * @param path Chemin du fichier d'index
+     * @param offset Taille actuelle du fichier de logs, les logs précédents ne sont pas indexés
+     * @param max_records Nombre maximum de logs par bloc
+     * @param max_duration Durée maximum couverte par un bloc
+     */
+    LogIndexWriter(std::string const &path, uint64_t offset, size_t max_records,
+                   std::chrono::milliseconds max_duration);
+
+    /**
+     * @brief Ecrit le bloc en cours
+     *
+     */
+    ~LogIndexWriter();
+
+    /**
+     * @brief Enregistre un log venant d'etre écrit a la fin du fichier de logs
+     *
+     * @param size Nombre d'octets écrits
+     * @param level Niveau du log
+     * @param timestamp Date de capture du log, en nanosecondes depuis l'epoch
+     */
+    void record(size_t size, Log::log_level level, uint64_t timestamp);
+
+    /**
+     * @brief Ecrit le bloc en cours dans l'index, et commence un nouveau bloc
+     *
+     */
+    void flush();
+  };
+}   // namespace tscl
@@ -0,0 +1,144 @@
+#pragma once
+#include "Logger.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace tscl {
+
+  /**
+   * @brief Regle de routage : les logs vérifiant toutes ses conditions sont envoyés au gestionnaire
+   *
+   * Un gestionnaire visé par au moins une regle ne recoit plus que les logs vérifiant l'une de ses
+   * regles. Les gestionnaires visés par aucune regle recoivent tout les logs, comme sans routage
+   *
+   */
+  struct LogRoute {
+    /**
+     * @brief Nom du gestionnaire destinataire
+     *
+     */
+    std::string handler;
+
+    Log::log_level min_level = Log::Trace;
+    Log::log_level max_level = Log::Fatal;
+
+    /**
+     * @brief Catégories acceptées, sous-catégories comprises ("net" accepte "net.http"). Vide pour
+     * accepter toutes les catégories
+     *
+     */
+    std::vector<std::string> categories;
+
+    /**
+     * @brief Codes d'erreur acceptés (voir Log::errorCode()). Vide pour accepter tout les codes
+     *
+     */
+    std::vector<long> error_codes;
+
+    /**
+     * @brief Le message doit contenir l'une de ces chaines. Vide pour accepter tout les messages
+     *
+     */
+    std::vector<std::string> contains;
+  };
+
+  /**
+   * @brief Ensemble de regles de routage compilé
+   *
+   * Chaque condition est précalculée sous forme de masque de bits des regles la vérifiant : un
+   * masque par niveau, par catégorie et par code d'erreur, et un automate d'Aho-Corasick pour les
+   * sous-chaines, parcouru une seule fois par message. Evaluer un log n'alloue jamais de mémoire
+   *
+   */
+  class LogRouter {
+  public:
+    /**
+     * @brief Nombre maximum de regles, et de gestionnaires distincts visés par les regles
+     *
+     */
+    static constexpr size_t max_routes = 64;
+
+  private:
+    /**
+     * @brief Noms des gestionnaires visés, le bit i d'un masque de gestionnaires désigne m_handlers[i]
+     *
+     */
+    std::vector<std::string> m_handlers;
+
+    /**
+     * @brief Masque de gestionnaires de chaque regle
+     *
+     */
+    std::vector<uint64_t> m_route_handlers;
+
+    uint64_t m_by_level[Log::Fatal + 1] = {};
+
+    /**
+     * @brief Regles acceptant toutes les catégories, et masques des catégories nommées triés par nom
+     *
+     */
+    uint64_t m_any_category = 0;
+    std::vector<std::pair<std::string, uint64_t>> m_by_category;
+
+    uint64_t m_any_code = 0;
+    std::vector<std::pair<long, uint64_t>> m_by_code;
+
+    /**
+     * @brief Regles n'ayant pas de condition sur le message
+     *
+     */
+    uint64_t m_any_message = 0;
+
+    /**
+     * @brief Automate d'Aho-Corasick déterministe. Les octets sont regroupés en classes (un octet
+     * absent des motifs appartient a la classe 0), la transition depuis l'état s pour la classe c est
+     * m_transitions[s * m_class_count + c]
+     *
+     */
+    uint16_t m_classes[256] = {};
+    size_t m_class_count = 1;
+    std::vector<uint32_t> m_transitions;
+
+    /**
+     * @brief Regles dont un motif se termine dans chaque état
+     *
+     */
+    std::vector<uint64_t> m_outputs;
+
+    LogRouter() = default;
+
+    uint64_t categoryRoutes(LogCategory const *category) const noexcept;
+    uint64_t codeRoutes(long code) const noexcept;
+    uint64_t messageRoutes(std::string_view message, uint64_t wanted) const noexcept;
+
+    void compileMessages(std::vector<LogRoute> const &routes);
+
+  public:
+    /**
+     * @brief Compile un ensemble de regles
+     *
+     * @param routes Les regles, au plus max_routes
+     * @return std::optional<LogRouter> Le routeur, ou std::nullopt si les regles sont trop nombreuses
+     */
+    static std::optional<LogRouter> compile(std::vector<LogRoute> const &routes);
+
+    /**
+     * @brief Noms des gestionnaires visés par au moins une regle
+     *
+     */
+    std::vector<std::string> const &handlers() const noexcept { return m_handlers; }
+
+    /**
+     * @brief Retourne les gestionnaires devant recevoir un log
+     *
+     * @param log Le log
+     * @param message Son message
+     * @return uint64_t Masque des gestionnaires, bit i pour handlers()[i]
+     */
+    uint64_t route(Log const &log, std::string_view message) const noexcept;
+  };
+}   // namespace tscl
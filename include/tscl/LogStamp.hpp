@@ -0,0 +1,138 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tscl {
+
+  /**
+   * @brief Identité d'un log : niveau, thread et date, capturés lorsqu'il est transmis aux
+   * gestionnaires, puis numéro de séquence, attribué par chaque gestionnaire lors de l'écriture
+   *
+   * Chaque gestionnaire numérote de 1 en 1 les logs qu'il écrit, apres filtrage et routage. Sa
+   * sortie est donc une suite sans trou, quels que soient les autres gestionnaires et Logger du
+   * programme : un numéro manquant est un log perdu apres son passage dans le gestionnaire. Les
+   * logs de threads différents s'ordonnent par date de capture
+   *
+   */
+  struct LogStamp {
+    /**
+     * @brief Rang du log parmi ceux écrits par le meme gestionnaire, a partir de 1. 0 tant que le
+     * log n'est pas numéroté
+     *
+     */
+    uint64_t sequence = 0;
+
+    /**
+     * @brief Date de capture, en nanosecondes depuis l'epoch (horloge systeme)
+     *
+     */
+    uint64_t time = 0;
+
+    /**
+     * @brief Identifiant systeme du thread (gettid)
+     *
+     */
+    uint32_t thread = 0;
+
+    /**
+     * @brief Niveau du log (Log::log_level)
+     *
+     */
+    uint8_t level = 0;
+
+    /**
+     * @brief Capture la date et le thread d'un nouveau log sur le thread courant. Le log n'est pas
+     * encore numéroté
+     *
+     * @param level Niveau du log
+     */
+    static LogStamp capture(uint8_t level) noexcept;
+
+    /**
+     * @brief Date de capture sous forme de time_point
+     *
+     */
+    std::chrono::system_clock::time_point timePoint() const noexcept {
+      return std::chrono::system_clock::time_point(
+              std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(time)));
+    }
+
+    /**
+     * @brief Ajoute le niveau, le numéro et le thread a la fin d'un string, au format "#I42 t1234 ".
+     * N'ajoute rien si le log n'est pas numéroté
+     *
+     * @param out String de sortie
+     */
+    void render(std::string &out) const;
+
+    /**
+     * @brief Relit l'identité d'une ligne commencant par le format de render(). La date n'est pas
+     * relue
+     *
+     * @param line La ligne
+     * @return std::optional<LogStamp> L'identité, ou std::nullopt si la ligne n'en commence pas par une
+     */
+    static std::optional<LogStamp> parse(std::string_view line) noexcept;
+  };
+
+  /**
+   * @brief Vérifie que la suite de numéros de séquence écrite par un gestionnaire, recue dans le
+   * désordre, est complete
+   *
+   * Un fichier peut contenir les sorties successives de plusieurs gestionnaires (fichier rouvert par
+   * un nouveau programme), dont les numéros recommencent a 1 : un second numéro 1 ouvre donc une
+   * nouvelle suite. Seuls les trous entre le plus petit et le plus grand numéro de chaque suite sont
+   * détectés
+   *
+   */
+  class SequenceChecker {
+  public:
+    /**
+     * @brief Numéros manquants d'une suite, bornes incluses
+     *
+     */
+    struct Gap {
+      uint64_t first;
+      uint64_t last;
+    };
+
+  private:
+    struct Stream {
+      bool has_first = false;
+      std::vector<uint64_t> sequences;
+    };
+
+    std::vector<Stream> m_streams;
+
+    size_t m_size = 0;
+
+  public:
+    void add(uint64_t sequence);
+
+    void add(LogStamp const &stamp) { add(stamp.sequence); }
+
+    /**
+     * @brief Nombre de numéros reçus
+     *
+     */
+    size_t size() const noexcept { return m_size; }
+
+    /**
+     * @brief Numéros manquants de chaque suite
+     *
+     * @return std::vector<Gap> Les intervalles manquants
+     */
+    std::vector<Gap> gaps();
+
+    /**
+     * @brief Nombre de numéros reçus plusieurs fois dans une meme suite
+     *
+     */
+    size_t duplicates();
+  };
+}   // namespace tscl
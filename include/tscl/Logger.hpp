@@ -7,8 +7,19 @@
 
 #pragma once
 
+#include "Compression.hpp"
+#include "LockProfile.hpp"
+#include "LogBuffer.hpp"
+#include "LogContext.hpp"
+#include "LogStamp.hpp"
+#include "StackTrace.hpp"
 #include "Time.hpp"
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <functional>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include <thread>
 #include <unordered_map>
@@ -25,11 +36,23 @@ namespace tscl {
       ERR_NONE = 0,
       ERR_ALLOCATION_FAILURE,
       ERR_ALREADY_EXISTING_HANDLER,
-      ERR_UNKNOWN_HANDLER
+      ERR_UNKNOWN_HANDLER,
+      ERR_INVALID_CONFIG,
+      ERR_UNREADABLE_CONFIG,
+      ERR_CONFIG_WATCH_FAILURE,
+      ERR_THREAD_SETUP_FAILURE
     };
   }
 
   struct LoggerConfig;
+  class LogCategory;
+  class Logger;
+  class LogIndexWriter;
+  class AsyncBackend;
+  class LogOperation;
+  class BackendOperation;
+  class LogRouter;
+  struct LogRoute;
 
   // ==================================================================
   // ===                         Basic Logs                         ===
@@ -53,9 +76,21 @@ namespace tscl {
      *
      * @param level Niveau de log a formatté
      *
-     * @return const std::string& Retourne une string contenant le niveau du log
+     * @return std::string_view Le niveau du log, issu d'une table constante
      */
-    static std::string const &levelToString(log_level level);
+    static constexpr std::string_view levelToString(log_level level) noexcept {
+      constexpr std::string_view names[] = {"[Trace]",   "[Debug]", "[Information]",
+                                            "[Warning]", "[Error]", "[Fatal]"};
+      return level >= Trace and level <= Fatal ? names[level] : std::string_view("[Unknown]");
+    }
+
+    /**
+     * @brief Méthode permettant de retrouver un niveau a partir de son nom (Trace, debug, ...)
+     *
+     * @param name Nom du niveau, insensible a la casse
+     * @return std::optional<log_level> Le niveau, ou std::nullopt si le nom est inconnu
+     */
+    static std::optional<log_level> levelFromString(std::string_view name);
 
   private:
     /**
@@ -64,6 +99,33 @@ namespace tscl {
      */
     log_level m_level;
 
+    /**
+     * @brief Catégorie par laquelle le log a été émis, nullptr si le log a été envoyé directement
+     * au Logger
+     *
+     */
+    LogCategory const *m_category;
+
+    /**
+     * @brief Contexte du thread ayant construit le log. N'est formaté que lors de l'affichage
+     *
+     */
+    LogContext const *m_context;
+
+    /**
+     * @brief Thread et date du log, capturés lorsqu'il est transmis a des gestionnaires (voir
+     * capture()). Le numéro de séquence est attribué par chaque gestionnaire
+     *
+     */
+    mutable LogStamp m_stamp;
+
+    /**
+     * @brief Préfixe déja formaté par un autre processus, affiché a la place du niveau, de la
+     * catégorie et du contexte. Vide pour un log émis localement
+     *
+     */
+    std::string_view m_origin;
+
     /**
      * @brief Méthode abstraite permettant de récuperer le messages contenu dans le log
      *
@@ -71,6 +133,15 @@ namespace tscl {
      */
     virtual std::string messageImpl() const = 0;
 
+  protected:
+    /**
+     * @brief Setter pour le préfixe d'origine d'un log relayé depuis un autre processus. Le texte
+     * n'est pas copié et doit vivre aussi longtemps que le log
+     *
+     * @param prefix Le préfixe formaté, sans timestamp
+     */
+    void origin(std::string_view prefix) { m_origin = prefix; }
+
   public:
     /**
      * @brief Constructeur par défaut du log
@@ -79,6 +150,15 @@ namespace tscl {
      */
     Log(log_level level = Trace);
 
+    /**
+     * @brief Constructeur d'un log reconstruit a partir d'un log capturé ailleurs (thread de fond,
+     * autre processus), qui conserve son identité d'origine
+     *
+     * @param level Niveau du log
+     * @param stamp Identité du log d'origine
+     */
+    Log(log_level level, LogStamp const &stamp);
+
     /**
      * @brief Setter pour le niveau du log
      *
@@ -93,6 +173,59 @@ namespace tscl {
      */
     log_level level() const;
 
+    /**
+     * @brief Setter pour la catégorie du log
+     *
+     * @param category Nouvelle catégorie du log
+     */
+    void category(LogCategory const *category) { m_category = category; }
+
+    /**
+     * @brief Getter pour la catégorie du log
+     *
+     * @return LogCategory const* La catégorie, ou nullptr si le log n'en a pas
+     */
+    LogCategory const *category() const { return m_category; }
+
+    /**
+     * @brief Setter pour le contexte du log, permettant d'afficher un log depuis un autre thread
+     * avec un contexte capturé
+     *
+     * @param context Nouveau contexte, doit rester valide tant que le log est utilisé
+     */
+    void context(LogContext const *context) { m_context = context; }
+
+    /**
+     * @brief Getter pour le contexte du log
+     *
+     * @return LogContext const* Le contexte du thread ayant construit le log
+     */
+    LogContext const *context() const { return m_context; }
+
+    /**
+     * @brief Getter pour l'identité du log (numéro de séquence, thread, date de capture)
+     *
+     * @return LogStamp const&
+     */
+    LogStamp const &stamp() const { return m_stamp; }
+
+    /**
+     * @brief Getter pour le préfixe d'origine d'un log relayé depuis un autre processus
+     *
+     * @return std::string_view Le préfixe, vide pour un log émis localement
+     */
+    std::string_view origin() const { return m_origin; }
+
+    /**
+     * @brief Date le log s'il ne l'est pas déja. Appelé par le Logger uniquement pour les logs
+     * qu'au moins un gestionnaire accepte, afin que les logs filtrés ne paient pas la lecture de
+     * l'horloge
+     *
+     */
+    void capture() const noexcept {
+      if (not m_stamp.time) m_stamp = LogStamp::capture(m_level);
+    }
+
     /**
      * @brief Getter pour le message du log, formatter pour comprendre
      * la timestamp si nécessaire, ainsi que le niveau
@@ -101,6 +234,15 @@ namespace tscl {
      */
     virtual std::string prefix(tscl::timestamp_t ts_type) const;
 
+    /**
+     * @brief Ajoute le préfixe du log (timestamp, niveau, catégorie et contexte) a la fin d'un string,
+     * sans allocation intermédiaire
+     *
+     * @param out String de sortie
+     * @param ts_type Type de timestamp a utiliser
+     */
+    void appendPrefix(std::string &out, tscl::timestamp_t ts_type) const;
+
     /**
      * @brief Getter pour le message du log, formatter pour comprendre
      * la timestamp si nécessaire, ainsi que le niveau
@@ -108,6 +250,33 @@ namespace tscl {
      * @return std::string Le log formatter
      */
     virtual std::string message() const;
+
+    /**
+     * @brief Ajoute le message du log a la fin d'un string. Utilisé par le Logger avec un tampon
+     * réutilisé d'un log a l'autre, pour ne pas allouer a chaque log. Par défaut, appelle message()
+     *
+     * StringLog et ErrorLog écrivent directement dans le tampon, mais uniquement pour leur type
+     * exact : une classe dérivée redéfinissant message() ou messageImpl() est toujours respectée
+     *
+     * @param out String de sortie
+     */
+    virtual void appendMessage(std::string &out) const;
+
+    /**
+     * @brief Pile d'appels capturée a la création du log. Ni message() ni appendMessage() ne
+     * l'incluent : le Logger l'affiche apres le message, ce qui permet de différer la résolution
+     * des symboles au thread d'affichage
+     *
+     * @return StackTrace const* La pile, ou nullptr si aucune pile n'a été capturée
+     */
+    virtual StackTrace const *stackTrace() const { return nullptr; }
+
+    /**
+     * @brief Code d'erreur porté par le log, utilisé par le routage
+     *
+     * @return long Le code, errors::ERR_NONE si le log n'est pas une erreur
+     */
+    virtual long errorCode() const { return errors::ERR_NONE; }
   };
 
   /**
@@ -117,10 +286,10 @@ namespace tscl {
   class StringLog : public Log {
   protected:
     /**
-     * @brief String contenant le message a transmettre
+     * @brief Message a transmettre, stocké sans allocation s'il est court
      *
      */
-    std::string m_str;
+    LogBuffer m_str;
 
     /**
      * @brief Surcharge de la méthode mére pour récuperer le contenu du message.
@@ -143,14 +312,7 @@ namespace tscl {
      * @param message Message a transmettre
      * @param level Niveau du message
      */
-    StringLog(std::string const &message, log_level level = Log::Trace);
-
-    /**
-     * @brief Constructeur de base a partir d'un message, utilise la sémantique de mouvement
-     *
-     * @param message Message a copier par mouvement
-     */
-    StringLog(std::string &&message, log_level level = Log::Trace);
+    StringLog(std::string_view message, log_level level = Log::Trace);
 
     /**
      * @brief Constructeur de copie
@@ -181,6 +343,59 @@ namespace tscl {
      * @return StringLog& La copie de l'objet
      */
     StringLog &operator=(StringLog &&other);
+
+    virtual void appendMessage(std::string &out) const override;
+  };
+
+  /**
+   * @brief Concept décrivant un callable capable de produire le message d'un log
+   *
+   */
+  template<typename TFunc>
+  concept LazyMessage = std::invocable<TFunc &> and
+                        std::convertible_to<std::invoke_result_t<TFunc &>, std::string>;
+
+  /**
+   * @brief Log dont le message n'est construit qu'au moment ou il est réellement affiché
+   *
+   * Le callable est invoqué au plus une fois, lors du premier appel a message(). Si aucun
+   * gestionnaire n'accepte le niveau du log, il n'est jamais invoqué.
+   *
+   * @tparam TFunc Type du callable produisant le message
+   */
+  template<LazyMessage TFunc>
+  class LazyLog : public Log {
+  private:
+    /**
+     * @brief Callable produisant le message
+     *
+     */
+    mutable TFunc m_func;
+
+    /**
+     * @brief Message mis en cache aprés la premiere invocation
+     *
+     */
+    mutable std::optional<std::string> m_str;
+
+    /**
+     * @brief Invoque le callable si nécessaire, puis renvoi le message mis en cache
+     *
+     * @return std::string Le message
+     */
+    virtual std::string messageImpl() const override {
+      if (not m_str) m_str.emplace(m_func());
+      return " - " + *m_str;
+    }
+
+  public:
+    /**
+     * @brief Construit un log paresseux a partir d'un callable et d'un niveau optionnel
+     *
+     * @param func Callable produisant le message
+     * @param level Niveau du message
+     */
+    explicit LazyLog(TFunc func, log_level level = Log::Trace) : Log(level), m_func(std::move(func)) {}
   };
 
   // ==================================================================
@@ -196,10 +411,10 @@ namespace tscl {
   class ErrorLog : public StringLog {
   protected:
     /**
-     * @brief Description optionnelle de l'erreur
+     * @brief Description optionnelle de l'erreur, déja mise en forme
      *
      */
-    std::string m_description;
+    LogBuffer m_description;
 
 
     /**
@@ -208,6 +423,13 @@ namespace tscl {
      */
     long m_error_code;
 
+    /**
+     * @brief Pile d'appels capturée a la construction, vide si la capture est désactivée pour ce
+     * niveau
+     *
+     */
+    StackTrace m_trace;
+
     /**
      * @brief Méthode abstraite permettant de récuperer le messages
      * contenu dans le log
@@ -216,6 +438,12 @@ namespace tscl {
      */
     virtual std::string messageImpl() const override;
 
+    /**
+     * @brief Ajoute le code d'erreur, au format "[0x2a]", a la fin d'un string
+     *
+     */
+    void appendCode(std::string &out) const;
+
   public:
     /**
      * @brief Constructeur de base pour une erreurs, prenant une erreur, un code erreur, ainsi
@@ -226,8 +454,8 @@ namespace tscl {
      * @param level Niveau de l'erreur
      * @param description Une description optionelle de l'erreur
      */
-    ErrorLog(std::string const &error, long code = errors::ERR_NONE,
-             Log::log_level level = Log::Error, std::string const &description = "");
+    ErrorLog(std::string_view error, long code = errors::ERR_NONE,
+             Log::log_level level = Log::Error, std::string_view description = "");
 
     /**
      * @brief Constructeur de copie par défaut
@@ -261,14 +489,39 @@ namespace tscl {
 
     /**
      * @brief Fonction surchargé pour pouvoir afficher correctement l'erreurs, y compris le code
-     * d'erreurs et la description
+     * d'erreurs et la description. La pile d'appels n'est pas incluse, voir stackTrace()
      *
      * @param ts_type le type de timestamp a utilisé
      * @return std::string le message correctement formaté
      */
     virtual std::string message() const override;
 
-    long errorCode() { return m_error_code; }
+    virtual void appendMessage(std::string &out) const override;
+
+    virtual StackTrace const *stackTrace() const override { return m_trace.empty() ? nullptr : &m_trace; }
+
+    virtual long errorCode() const override { return m_error_code; }
+
+    /**
+     * @brief Indentation des lignes de la description et de la pile d'appels
+     *
+     */
+    static constexpr std::string_view indent = "\n |\t";
+
+    /**
+     * @brief Définit le niveau a partir duquel les erreurs capturent leur pile d'appels. Les
+     * ExceptionLog capturent leur pile quel que soit leur niveau, des que la capture est activée
+     *
+     * @param level Niveau minimum, std::nullopt pour désactiver la capture (par défaut)
+     */
+    static void traceLevel(std::optional<log_level> level) noexcept;
+
+    /**
+     * @brief Retourne le niveau a partir duquel les erreurs capturent leur pile d'appels
+     *
+     * @return std::optional<log_level> Le niveau, ou std::nullopt si la capture est désactivée
+     */
+    static std::optional<log_level> traceLevel() noexcept;
   };
 
   class ExceptionLog : public ErrorLog, public std::runtime_error {
@@ -284,9 +537,11 @@ namespace tscl {
      * @param level Niveau de l'erreur
      * @param description Une description optionelle de l'erreur
      */
-    ExceptionLog(std::string const &error, int code = errors::ERR_NONE,
-                 Log::log_level level = Log::Error, std::string const &description = "")
-        : ErrorLog(error, code, level, description) , std::runtime_error("") {}
+    ExceptionLog(std::string_view error, int code = errors::ERR_NONE,
+                 Log::log_level level = Log::Error, std::string_view description = "")
+        : ErrorLog(error, code, level, description) , std::runtime_error("") {
+      if (m_trace.empty() and traceLevel()) m_trace = StackTrace::capture();
+    }
   };
 
   // ==================================================================
@@ -303,15 +558,16 @@ namespace tscl {
      * @brief Status of the handler, true if the handler is active
      *
      */
-    bool m_enabled;
+    std::atomic<bool> m_enabled;
 
     /**
      * @brief Minimum level for logs to be treated
      *
-     * Logs under this level will not be handled by this handler
+     * Logs under this level will not be handled by this handler. Atomic so that the configuration
+     * can be reloaded while other threads are logging
      *
      */
-    Log::log_level m_min_level;
+    std::atomic<Log::log_level> m_min_level;
 
     /**
      * @brief The type of timestamp to use for this handler
@@ -319,6 +575,18 @@ namespace tscl {
      */
     tscl::timestamp_t m_ts_type;
 
+    /**
+     * @brief Vrai si chaque ligne commence par le numéro de séquence et le thread du log
+     *
+     */
+    bool m_stamped;
+
+    /**
+     * @brief Dernier numéro de séquence attribué par le gestionnaire
+     *
+     */
+    mutable std::atomic<uint64_t> m_sequence;
+
     /**
      * @brief Construct a new Log Handler object
      *
@@ -342,6 +610,14 @@ namespace tscl {
      */
     std::shared_mutex m_main_mutex;
 
+    /**
+     * @brief Codes ANSI colorant les logs de chaque niveau, et code rétablissant la couleur par défaut
+     *
+     */
+    static constexpr std::string_view ansi_colors[Log::Fatal + 1] = {
+            "\033[39;90m", "\033[39;36m", "\033[39;34m", "\033[39;33m", "\033[39;31m", "\033[39;35m"};
+    static constexpr std::string_view ansi_reset = "\033[0m";
+
   public:
     /**
      * @brief Constructeur du log handler, initialisant correctement la config
@@ -359,12 +635,18 @@ namespace tscl {
      */
     virtual void log(Log const &log, std::string const &message) = 0;
 
+    /**
+     * @brief Force l'écriture des logs mis en tampon par ce handler
+     *
+     */
+    virtual void flush() {}
+
     /**
      * @brief Active ou desactive ce handler
      *
      * @param val Vrai ou faux, dependamment si il faut activer ou désactiver ce handler
      */
-    void enable(bool val) { m_enabled = val; }
+    void enable(bool val) { m_enabled.store(val, std::memory_order_relaxed); }
 
     /**
      * @brief Getter retournant le statut de ce handler
@@ -372,21 +654,29 @@ namespace tscl {
      * @return true Si ce handler est actif
      * @return false Sinon
      */
-    bool enable() const { return m_enabled; }
+    bool enable() const { return m_enabled.load(std::memory_order_relaxed); }
 
     /**
      * @brief Setter pour définir le niveau minimum des logs a traité
      *
      * @param val
      */
-    void minLvl(Log::log_level val) { m_min_level = val; }
+    void minLvl(Log::log_level val) { m_min_level.store(val, std::memory_order_relaxed); }
 
     /**
      * @brief Getter pour obtenir le niveau minimum des logs traité
      *
      * @return Log::log_level
      */
-    Log::log_level minLvl() const { return m_min_level; }
+    Log::log_level minLvl() const { return m_min_level.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Indique si ce handler traitera un log du niveau donné
+     *
+     * @param level Niveau du log
+     * @return true Si le handler est actif et que le niveau est suffisant
+     */
+    bool accepts(Log::log_level level) const { return enable() and level >= minLvl(); }
 
     /**
      * @brief Setter pour définir le style de timestamp a utilisé
@@ -401,6 +691,36 @@ namespace tscl {
      * @return util::time::timestamp_t Le style de timestamp a utilisé
      */
     timestamp_t tsType() const { return m_ts_type; }
+
+    /**
+     * @brief Setter pour afficher le niveau, le numéro de séquence et le thread en tete de chaque
+     * ligne, au format "#I42 t1234 ". Le gestionnaire numérote les logs qu'il écrit, ce qui permet
+     * d'y détecter des logs manquants (voir SequenceChecker)
+     *
+     * @param stamped
+     */
+    void stamped(bool stamped) { m_stamped = stamped; }
+
+    bool stamped() const { return m_stamped; }
+
+  protected:
+    /**
+     * @brief Ajoute l'en-tete d'une ligne (numéro de séquence si activé, puis préfixe du log) a la
+     * fin d'un string. Chaque appel attribue un nouveau numéro : il ne doit etre fait qu'une fois par
+     * log écrit
+     *
+     * @param out String de sortie
+     * @param log Le log
+     */
+    void appendHeader(std::string &out, Log const &log) const {
+      if (m_stamped) {
+        LogStamp stamp = log.stamp();
+        stamp.sequence = m_sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+        stamp.render(out);
+      }
+
+      log.appendPrefix(out, m_ts_type);
+    }
   };
 
   /**
@@ -409,14 +729,6 @@ namespace tscl {
    */
   class StreamLogHandler : public LogHandler {
   private:
-    /**
-     * @brief Méthode utilitaire pour colorer les messages
-     *
-     * @param level
-     * @return std::string
-     */
-    std::string colorize(Log::log_level level);
-
     /**
      * @brief Pointeur sur le stream de sortie
      *
@@ -437,6 +749,24 @@ namespace tscl {
      */
     bool m_use_ascii_color;
 
+    /**
+     * @brief Index optionnel du fichier de sortie
+     *
+     */
+    std::unique_ptr<LogIndexWriter> m_index;
+
+    /**
+     * @brief Chemin du fichier de sortie, vide si le handler écrit dans un stream extérieur
+     *
+     */
+    std::string m_path;
+
+    /**
+     * @brief Tampon compressant le fichier de sortie, nullptr si le fichier n'est pas compressé
+     *
+     */
+    std::unique_ptr<CompressedStreamBuf> m_compressor;
+
   public:
     /**
      * @brief Construit un Handler a partir d'un stream déja existant
@@ -452,6 +782,18 @@ namespace tscl {
      */
     StreamLogHandler(std::string const &path);
 
+    /**
+     * @brief Construit un Handler vers un fichier compressé par blocs, lisible avec tscl-decode.
+     * La compression est effectuée par un thread dédié. Un log n'est écrit sur le disque qu'une fois
+     * son bloc plein, au plus tard une seconde apres, ou lors d'un appel a flush()
+     *
+     * @param path Chemin du fichier a ouvrir
+     * @param compress Active la compression, sinon équivalent au constructeur précédent
+     * @param block_size Taille des blocs avant compression
+     */
+    StreamLogHandler(std::string const &path, bool compress,
+                     size_t block_size = CompressedStreamBuf::default_block_size);
+
     /**
      * @brief Désalloue la mémoire si l'objet est propriétaire du stream
      *
@@ -465,6 +807,25 @@ namespace tscl {
      */
     virtual void log(Log const &log, std::string const &message);
 
+    /**
+     * @brief Vide le tampon du stream de sortie
+     *
+     */
+    virtual void flush() override;
+
+    /**
+     * @brief Active l'écriture d'un index a coté du fichier de sortie (chemin + ".idx"), permettant
+     * a tscl-grep de ne parcourir que les portions utiles du fichier. Une entrée est ajoutée tout les
+     * max_records logs, ou toutes les max_duration
+     *
+     * @param max_records Nombre maximum de logs par entrée
+     * @param max_duration Durée maximum couverte par une entrée
+     * @return true Si l'index a été activé, false si le handler n'écrit pas dans un fichier qu'il a ouvert,
+     * ou si ce fichier est compressé. Les logs écrits avant l'activation ne sont pas indexés
+     */
+    bool enableIndex(size_t max_records = 1024,
+                     std::chrono::milliseconds max_duration = std::chrono::milliseconds(1000));
+
     /**
      * @brief Setter permettant de définir l'utilisation des codes couleurs ascii
      *
@@ -487,12 +848,229 @@ namespace tscl {
     }
   };
 
+  // ==================================================================
+  // ===                         Categories                         ===
+  // ==================================================================
+
+  /**
+   * @brief Logger nommé ("net.http", "db.pool", ...) possédant son propre niveau minimum
+   *
+   * Les catégories forment une hiérarchie a partir de leur nom : "net.http" hérite du niveau de
+   * "net", qui hérite lui meme de la catégorie racine, sauf si un niveau leur a été explicitement
+   * attribué. Le niveau effectif est résolu a chaque changement de configuration, le filtrage ne
+   * coute donc qu'une lecture atomique
+   *
+   */
+  class LogCategory {
+    friend class Logger;
+
+  private:
+    /**
+     * @brief Logger auquel sont transmis les logs de cette catégorie
+     *
+     */
+    Logger &m_logger;
+
+    /**
+     * @brief Nom complet de la catégorie
+     *
+     */
+    std::string m_name;
+
+    /**
+     * @brief Catégorie parente, nullptr pour la catégorie racine
+     *
+     */
+    LogCategory *m_parent;
+
+    /**
+     * @brief Niveau explicitement attribué a cette catégorie, protégé par le Logger
+     *
+     */
+    std::optional<Log::log_level> m_level;
+
+    /**
+     * @brief Niveau effectif, résolu a partir de la hiérarchie
+     *
+     */
+    std::atomic<Log::log_level> m_effective_level;
+
+    /**
+     * @brief Constructeur privé, les catégories sont créées par Logger::category()
+     *
+     */
+    LogCategory(Logger &logger, std::string name, LogCategory *parent);
+
+    /**
+     * @brief Associe le log a cette catégorie et le transmet au Logger
+     *
+     * @param log Le log a transmettre
+     */
+    void dispatch(Log &log) noexcept;
+
+  public:
+    LogCategory(LogCategory const &) = delete;
+    LogCategory &operator=(LogCategory const &) = delete;
+
+    /**
+     * @brief Getter pour le nom de la catégorie
+     *
+     * @return std::string const& Le nom complet, vide pour la catégorie racine
+     */
+    std::string const &name() const { return m_name; }
+
+    /**
+     * @brief Getter pour la catégorie parente
+     *
+     * @return LogCategory* La catégorie parente, nullptr pour la catégorie racine
+     */
+    LogCategory *parent() const { return m_parent; }
+
+    /**
+     * @brief Indique si un log du niveau donné passe le filtre de cette catégorie
+     *
+     * @param level Niveau du log
+     * @return true Si le niveau est supérieur ou égal au niveau effectif
+     */
+    bool enabled(Log::log_level level) const noexcept {
+      return level >= m_effective_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Getter pour le niveau effectif de la catégorie
+     *
+     * @return Log::log_level Le niveau effectif
+     */
+    Log::log_level level() const noexcept { return m_effective_level.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Attribue explicitement un niveau a cette catégorie, et a ses enfants qui n'en ont pas
+     *
+     * @param level Nouveau niveau
+     */
+    void level(Log::log_level level);
+
+    /**
+     * @brief Retire le niveau explicite de cette catégorie, qui hérite alors de son parent
+     *
+     */
+    void resetLevel();
+
+    /**
+     * @brief Envoie un log au travers de cette catégorie
+     *
+     * @param log Le log a envoyer
+     * @return LogCategory&
+     */
+    LogCategory &operator()(Log &&log) noexcept;
+
+    /**
+     * @brief Envoie un log au travers de cette catégorie. Le log sera associé a la catégorie
+     *
+     * @param log Le log a envoyer
+     * @return LogCategory&
+     */
+    LogCategory &operator()(Log &log) noexcept;
+
+    /**
+     * @brief Envoie un message au travers de cette catégorie
+     *
+     * @param msg Le message
+     * @param level Niveau du message
+     * @return LogCategory&
+     */
+    LogCategory &operator()(std::string_view msg, Log::log_level level = Log::Trace) noexcept;
+
+    /**
+     * @brief Envoie un message construit a la demande au travers de cette catégorie
+     *
+     * @param func Callable produisant le message
+     * @param level Niveau du message
+     * @return LogCategory&
+     */
+    template<LazyMessage TFunc>
+    LogCategory &operator()(TFunc &&func, Log::log_level level = Log::Trace) noexcept {
+      if (not enabled(level)) return *this;
+
+      LazyLog<std::decay_t<TFunc>> tmp(std::forward<TFunc>(func), level);
+      dispatch(tmp);
+      return *this;
+    }
+  };
+
   // ==================================================================
   // ===                         Logger                             ===
   // ==================================================================
 
   /**
-   * @brief Singleton responsable de la bonne gestion des logs
+   * @brief Configuration du thread de fond traitant les logs asynchrones
+   *
+   */
+  struct BackendConfig {
+    /**
+     * @brief Comportement du thread lorsque la file est vide
+     *
+     * Spin : attente active permanente, latence minimale mais occupe un coeur.
+     * Yield : attente active puis sched_yield, sans jamais s'endormir.
+     * Park : attente active puis sched_yield, puis endormissement sur un futex. La durée de l'attente
+     * active s'adapte selon qu'elle suffit ou non a recevoir le log suivant
+     *
+     */
+    enum wait_t { Spin, Yield, Park };
+
+    wait_t wait = Park;
+
+    /**
+     * @brief Nombre maximum d'itérations d'attente active avant de céder le processeur
+     *
+     */
+    uint32_t spin = 1000;
+
+    /**
+     * @brief Nombre d'appels a sched_yield avant de s'endormir, pour Park
+     *
+     */
+    uint32_t yield = 10;
+
+    /**
+     * @brief Coeur sur lequel fixer le thread, -1 pour ne pas le fixer
+     *
+     */
+    int cpu = -1;
+
+    /**
+     * @brief Nom du thread, tronqué a 15 caracteres
+     *
+     */
+    std::string name = "tscl-backend";
+
+    /**
+     * @brief Nombre maximum de logs traités avant de consulter les demandes en attente
+     *
+     */
+    size_t batch = 256;
+
+    /**
+     * @brief Capacité de la file, prise en compte uniquement au démarrage du thread
+     *
+     */
+    size_t capacity = 1024;
+
+    /**
+     * @brief Retourne la stratégie correspondant a un nom, sans tenir compte de la casse
+     *
+     * @param name "spin", "yield" ou "park"
+     * @return std::optional<wait_t> La stratégie, ou std::nullopt si le nom est inconnu
+     */
+    static std::optional<wait_t> waitFromString(std::string_view name);
+  };
+
+  /**
+   * @brief Responsable de la bonne gestion des logs
+   *
+   * Chaque instance possède ses propres gestionnaires, catégories, regles de routage et thread de
+   * fond, et ne partage aucun verrou avec les autres : un sous-systeme bavard peut ainsi etre isolé
+   * d'un chemin critique. L'instance par défaut est accessible via singleton() et tscl::logger()
    *
    */
   class Logger {
@@ -504,33 +1082,169 @@ namespace tscl {
     std::unordered_map<std::string, std::unique_ptr<LogHandler>> m_loggers;
 
     /**
-     * @brief Constructeur privé pour maintenir l'état de singleton
+     * @brief Regles de routage compilées, nullptr si tout les gestionnaires recoivent tout les logs
      *
      */
-    Logger(){};
+    std::unique_ptr<LogRouter> m_router;
 
     /**
-     * @brief Suppression du constructeur de copie pour maintenir l'état de singleton
+     * @brief Gestionnaires visés par les regles, dans l'ordre de LogRouter::handlers(). nullptr si
+     * le gestionnaire n'existe pas (encore)
      *
      */
-    Logger(Logger const &) = delete;
+    std::vector<LogHandler *> m_routed;
 
     /**
-     * @brief Suppression du l'assignation de copie pour maintenir l'état de singleton
+     * @brief Gestionnaires visés par aucune regle, qui recoivent tout les logs
      *
-     * @return Logger&
      */
-    Logger &operator=(Logger const &) = delete;
+    std::vector<LogHandler *> m_unrouted;
 
     /**
-     * @brief Mutex permetant le log simultanés depuis plusieurs threads
+     * @brief Catégorie racine, dont héritent toutes les autres
      *
      */
-    std::shared_mutex m_main_mutex;
+    LogCategory m_root;
+
+    /**
+     * @brief Dictionnaire contenant toutes les catégories nommées
+     *
+     */
+    std::unordered_map<std::string, std::unique_ptr<LogCategory>> m_categories;
+
+    /**
+     * @brief Mutex protégeant les catégories et leurs niveaux explicites.
+     * N'est jamais pris lors du filtrage
+     *
+     */
+    std::mutex m_categories_mutex;
+
+    /**
+     * @brief Thread de fond traitant les logs asynchrones, démarré au premier appel a logAsync().
+     * Détruit avec le Logger
+     *
+     */
+    std::atomic<AsyncBackend *> m_backend;
+
+    /**
+     * @brief Configuration du backend, appliquée a son démarrage
+     *
+     */
+    BackendConfig m_backend_config;
+
+    /**
+     * @brief Mutex protégeant le démarrage et la configuration du backend
+     *
+     */
+    std::mutex m_backend_mutex;
+
+    /**
+     * @brief Retourne le backend asynchrone, en le démarrant si nécessaire
+     *
+     * @return AsyncBackend&
+     */
+    AsyncBackend &backend();
+
+    /**
+     * @brief Transmet un log dont le message est déja construit aux gestionnaires
+     *
+     * @param log Le log
+     * @param msg Son message
+     */
+    void dispatch(Log const &log, std::string const &msg) noexcept;
+
+    /**
+     * @brief Retire un gestionnaire sans attendre les logs asynchrones en attente
+     *
+     * @param name Nom du gestionnaire a retiré
+     */
+    void eraseHandler(std::string const &name);
+
+    /**
+     * @brief Force l'écriture des gestionnaires sans attendre les logs asynchrones en attente
+     *
+     */
+    void flushHandlers() noexcept;
+
+    /**
+     * @brief Transmet un log aux gestionnaires choisis par le routage. m_main_mutex doit etre verrouillé
+     *
+     * @param log Le log
+     * @param msg Son message
+     */
+    void deliver(Log const &log, std::string const &msg) noexcept;
+
+    /**
+     * @brief Associe les gestionnaires aux regles de routage, apres un changement de gestionnaires
+     * ou de regles. m_main_mutex doit etre verrouillé en écriture
+     *
+     */
+    void resolveRoutes();
+
+    /**
+     * @brief Retourne une catégorie, en la créant ainsi que ses parents si nécessaire.
+     * m_categories_mutex doit etre verrouillé
+     *
+     * @param name Nom de la catégorie
+     * @return LogCategory&
+     */
+    LogCategory &findOrCreateCategory(std::string_view name);
+
+    /**
+     * @brief Recalcule le niveau effectif de toutes les catégories.
+     * m_categories_mutex doit etre verrouillé
+     *
+     */
+    void updateCategories();
+
+    /**
+     * @brief Modifie le niveau explicite d'une catégorie puis propage le changement
+     *
+     * @param category La catégorie a modifier
+     * @param level Le nouveau niveau, std::nullopt pour hériter du parent
+     */
+    void categoryLevel(LogCategory &category, std::optional<Log::log_level> level);
+
+    friend class LogCategory;
+    friend class AsyncBackend;
+
+    /**
+     * @brief Mutex permetant le log simultanés depuis plusieurs threads. Ses durées de détention
+     * peuvent etre mesurées, voir lockProfiling()
+     *
+     */
+    ProfiledSharedMutex m_main_mutex;
 
   public:
     /**
-     * @brief Retourne le singleton
+     * @brief Construit un Logger indépendant, sans gestionnaire. Son thread de fond n'est démarré
+     * qu'au premier log asynchrone
+     *
+     */
+    Logger();
+
+    /**
+     * @brief Arrete le backend asynchrone apres avoir traité les logs en attente. Les catégories du
+     * Logger ne doivent plus etre utilisées
+     *
+     */
+    ~Logger();
+
+    /**
+     * @brief Suppression du constructeur de copie : les catégories et le backend référencent leur Logger
+     *
+     */
+    Logger(Logger const &) = delete;
+
+    /**
+     * @brief Suppression du l'assignation de copie
+     *
+     * @return Logger&
+     */
+    Logger &operator=(Logger const &) = delete;
+
+    /**
+     * @brief Retourne l'instance par défaut
      *
      * @return Logger&
      */
@@ -555,7 +1269,103 @@ namespace tscl {
      * @param level
      * @return Logger&
      */
-    Logger &operator()(std::string const &msg, Log::log_level level = Log::Trace) noexcept;
+    Logger &operator()(std::string_view msg, Log::log_level level = Log::Trace) noexcept;
+
+    /**
+     * @brief Fonction permettant d'envoyer un message construit a la demande.
+     * Le callable n'est invoqué que si au moins un gestionnaire accepte le niveau, et au plus
+     * une fois
+     *
+     * @param func Callable produisant le message
+     * @param level Niveau du message
+     * @return Logger&
+     */
+    template<LazyMessage TFunc>
+    Logger &operator()(TFunc &&func, Log::log_level level = Log::Trace) noexcept {
+      return operator()(LazyLog<std::decay_t<TFunc>>(std::forward<TFunc>(func), level));
+    }
+
+    /**
+     * @brief Envoie un log au thread de fond du Logger. Le message est construit immédiatement,
+     * l'écriture par les gestionnaires a lieu plus tard
+     *
+     * L'opération retournée peut etre attendue avec co_await : la coroutine n'est suspendue que si
+     * la file est pleine, et reprise une fois le log traité. Un log Fatal est traité de facon
+     * synchrone
+     *
+     * @param log Le log a envoyer
+     * @return LogOperation
+     */
+    LogOperation logAsync(Log const &log);
+
+    /**
+     * @brief Envoie un message au thread de fond du Logger
+     *
+     * @param msg Le message
+     * @param level Niveau du message
+     * @return LogOperation
+     */
+    LogOperation logAsync(std::string_view msg, Log::log_level level = Log::Trace);
+
+    /**
+     * @brief Envoie un message construit a la demande au thread de fond du Logger. Défini dans
+     * AsyncLogger.hpp
+     *
+     * @param func Callable produisant le message
+     * @param level Niveau du message
+     * @return LogOperation
+     */
+    template<LazyMessage TFunc>
+    LogOperation logAsync(TFunc &&func, Log::log_level level = Log::Trace);
+
+    /**
+     * @brief Retourne une opération a attendre avec co_await, reprise une fois les logs asynchrones
+     * déja envoyés écrits et tout les gestionnaires vidés
+     *
+     * @return BackendOperation
+     */
+    BackendOperation flushAsync();
+
+    /**
+     * @brief Retourne une opération a attendre avec co_await, reprise une fois les logs asynchrones
+     * déja envoyés traités et le gestionnaire retiré
+     *
+     * @param name Nom du gestionnaire a retiré
+     * @return BackendOperation
+     */
+    BackendOperation removeHandlerAsync(std::string name);
+
+    /**
+     * @brief Définit la facon dont les coroutines attendant le Logger sont reprises, par exemple en
+     * les postant sur l'exécuteur de l'application. Par défaut, elles sont reprises directement
+     * par le thread de fond
+     *
+     * @param resumer Fonction recevant la coroutine a reprendre, vide pour revenir au défaut
+     */
+    void resumeOn(std::function<void(std::coroutine_handle<>)> resumer);
+
+    /**
+     * @brief Modifie la configuration du thread de fond. S'il est déja démarré, tout est appliqué
+     * immédiatement sauf la capacité de la file
+     *
+     * @param config La configuration
+     */
+    void backendConfig(BackendConfig const &config);
+
+    /**
+     * @brief Retourne la configuration du thread de fond
+     *
+     * @return BackendConfig
+     */
+    BackendConfig backendConfig();
+
+    /**
+     * @brief Indique si au moins un gestionnaire traitera un log du niveau donné
+     *
+     * @param level Niveau du log
+     * @return true Si un gestionnaire actif accepte ce niveau
+     */
+    bool accepts(Log::log_level level) noexcept;
 
     /**
      * @brief Méthode permetant d'ajouter un gestionnaire au systeme de log
@@ -567,12 +1377,12 @@ namespace tscl {
      * @return LogHandler& Retourne une reference sur le nouveau gestionnaire
      */
     template<class THandler, typename... Args>
-    THandler &addHandler(std::string name, Args &...args) noexcept {
-      std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+    THandler &addHandler(std::string name, Args &&...args) noexcept {
+      std::unique_lock<ProfiledSharedMutex> lock(m_main_mutex);
       std::unique_ptr<LogHandler> buffer;
 
       try {
-        buffer = std::make_unique<THandler>(args...);
+        buffer = std::make_unique<THandler>(std::forward<Args>(args)...);
       } catch (std::bad_alloc& e) {
         operator()(ErrorLog("Failed log handler allocation", errors::ERR_ALLOCATION_FAILURE,
                             Log::Fatal,
@@ -580,6 +1390,7 @@ namespace tscl {
       }
 
       auto tmp = m_loggers.emplace(name, std::move(buffer));
+      if (tmp.second) resolveRoutes();
 
       lock.unlock();
 
@@ -588,7 +1399,7 @@ namespace tscl {
                                     "\" : already existing handler with the same name",
                             errors::ERR_ALREADY_EXISTING_HANDLER, Log::Warning));
       } else
-        operator()("Adding a new log handler : \"" + name + '\"');
+        operator()([&name]() { return "Adding a new log handler : \"" + name + '\"'; });
 
       auto &res = *tmp.first->second;
 
@@ -597,7 +1408,7 @@ namespace tscl {
 
     template<class THandler>
     THandler *getHandler(std::string const &name) noexcept {
-      std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+      std::unique_lock<ProfiledSharedMutex> lock(m_main_mutex);
 
       auto tmp = m_loggers.find(name);
       if (tmp == m_loggers.end()) {
@@ -614,17 +1425,113 @@ namespace tscl {
     }
 
     /**
-     * @brief Retire un gestionnaire de log du systeme
+     * @brief Retire un gestionnaire de log du systeme, apres traitement des logs asynchrones en attente
      *
      * @param name Nom du gestionnaire a retiré
      */
     void removeHandler(std::string name);
+
+    /**
+     * @brief Force l'écriture des logs mis en tampon par tout les gestionnaires, y compris les logs
+     * asynchrones en attente
+     *
+     */
+    void flush() noexcept;
+
+    /**
+     * @brief Arret a durée bornée : écrit les logs asynchrones en attente et vide tout les
+     * gestionnaires, en abandonnant l'attente une fois le délai écoulé
+     *
+     * A appeler avant de quitter le programme, pour que la destruction du Logger n'ait plus rien
+     * a écrire. Les logs envoyés ensuite sont toujours traités. Sans thread de fond, le délai ne
+     * s'applique pas au vidage des gestionnaires, effectué directement
+     *
+     * @param timeout Délai maximum
+     * @return true Si tout les logs ont été écrits dans le délai
+     */
+    bool shutdown(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)) noexcept;
+
+    /**
+     * @brief Remplace les regles de routage. Les gestionnaires visés par une regle ne recoivent plus
+     * que les logs vérifiant l'une de leurs regles, les autres recoivent tout les logs
+     *
+     * Les regles peuvent viser des gestionnaires qui n'ont pas encore été ajoutés
+     *
+     * @param routes Les regles, au plus LogRouter::max_routes
+     * @return true Si les regles ont été appliquées
+     */
+    bool routes(std::vector<LogRoute> const &routes);
+
+    /**
+     * @brief Supprime les regles de routage : tout les gestionnaires recoivent tout les logs
+     *
+     */
+    void clearRoutes();
+
+    /**
+     * @brief Active ou désactive la mesure des durées d'attente et de détention du verrou principal,
+     * pris par chaque log et chaque modification des gestionnaires
+     *
+     * @param enable
+     */
+    void lockProfiling(bool enable) noexcept { m_main_mutex.profiling(enable); }
+
+    bool lockProfiling() const noexcept { return m_main_mutex.profiling(); }
+
+    /**
+     * @brief Retourne les statistiques du verrou principal accumulées pendant le profilage
+     *
+     * @return LockProfile
+     */
+    LockProfile lockProfile() const noexcept { return m_main_mutex.profile(); }
+
+    void resetLockProfile() noexcept { m_main_mutex.resetProfile(); }
+
+    /**
+     * @brief Retourne la catégorie racine
+     *
+     * @return LogCategory&
+     */
+    LogCategory &root() noexcept { return m_root; }
+
+    /**
+     * @brief Retourne la catégorie correspondant au nom donné, en la créant si nécessaire.
+     * La référence retournée reste valide pendant toute la durée de vie du Logger
+     *
+     * @param name Nom de la catégorie, les niveaux de hiérarchie sont séparés par des points
+     * @return LogCategory&
+     */
+    LogCategory &category(std::string_view name);
+
+    /**
+     * @brief Applique une configuration : niveaux des catégories et des gestionnaires, et thread de fond.
+     * Les catégories absentes de la configuration perdent leur niveau explicite, les gestionnaires
+     * absents ne sont pas modifiés
+     *
+     * @param config La configuration a appliquer
+     */
+    void configure(LoggerConfig const &config);
   };
 
   /**
-   * @brief Objet global permettant de faciliter les opérations de logging
+   * @brief Accede a l'instance par défaut, construite lors du premier appel. Une référence globale
+   * serait initialisée dynamiquement, et pourrait etre lue avant de l'etre par l'initialisation d'une
+   * variable globale d'une autre unité de compilation
    *
+   * @return Logger& L'instance par défaut
    */
-  extern Logger &logger;
+  inline Logger &logger() { return Logger::singleton(); }
+
+  /**
+   * @brief Envoie un log a l'instance par défaut : tscl::logger("message", Log::Information)
+   *
+   * @param args Arguments de Logger::operator()
+   * @return Logger& L'instance par défaut
+   */
+  template<typename... TArgs>
+    requires(sizeof...(TArgs) > 0)
+  Logger &logger(TArgs &&...args) noexcept {
+    return Logger::singleton()(std::forward<TArgs>(args)...);
+  }
 
 }   // namespace tscl
\ No newline at end of file
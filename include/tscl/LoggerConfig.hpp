@@ -0,0 +1,153 @@
+#pragma once
+#include "Logger.hpp"
+#include <istream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tscl {
+
+  /**
+   * @brief Configuration du systeme de logs, pouvant etre chargée depuis un fichier
+   *
+   * Format du fichier :
+   * @code
+   * # Commentaire
+   * root = Information
+   *
+   * [categories]
+   * net.http = Debug
+   *
+   * [handlers]
+   * console = Warning
+   *
+   * [backend]
+   * wait = park       # spin, yield ou park
+   * spin = 1000
+   * yield = 10
+   * cpu = 3
+   * name = tscl-backend
+   * batch = 256
+   * capacity = 1024
+   * @endcode
+   *
+   */
+  struct LoggerConfig {
+    /**
+     * @brief Niveau de la catégorie racine
+     *
+     */
+    Log::log_level root_level = Log::Trace;
+
+    /**
+     * @brief Niveaux explicites des catégories, identifiées par leur nom complet
+     *
+     */
+    std::vector<std::pair<std::string, Log::log_level>> categories;
+
+    /**
+     * @brief Niveaux minimum des gestionnaires, identifiés par leur nom
+     *
+     */
+    std::vector<std::pair<std::string, Log::log_level>> handlers;
+
+    /**
+     * @brief Configuration du thread de fond, std::nullopt si la section [backend] est absente.
+     * Les clés absentes de la section gardent leur valeur par défaut
+     *
+     */
+    std::optional<BackendConfig> backend;
+
+    /**
+     * @brief Lit une configuration depuis un flux. Les lignes invalides sont ignorées et signalées
+     * par un avertissement
+     *
+     * @param in Flux a lire
+     * @param report Logger recevant les avertissements
+     * @return LoggerConfig La configuration lue
+     */
+    static LoggerConfig parse(std::istream &in, Logger &report = Logger::singleton());
+
+    /**
+     * @brief Lit une configuration depuis un fichier
+     *
+     * @param path Chemin du fichier
+     * @param report Logger recevant les avertissements
+     * @return std::optional<LoggerConfig> La configuration, ou std::nullopt si le fichier n'a pas pu
+     * etre ouvert
+     */
+    static std::optional<LoggerConfig> load(std::string const &path, Logger &report = Logger::singleton());
+  };
+
+  /**
+   * @brief Surveille un fichier de configuration a l'aide d'inotify, et l'applique au Logger a
+   * chaque modification
+   *
+   * Le rechargement est effectué par un thread dédié, et ne verrouille jamais le filtrage des logs
+   *
+   */
+  class ConfigWatcher {
+  private:
+    /**
+     * @brief Logger auquel appliquer la configuration
+     *
+     */
+    Logger &m_logger;
+
+    /**
+     * @brief Chemin du fichier surveillé
+     *
+     */
+    std::string m_path;
+
+    /**
+     * @brief Descripteur inotify, -1 si la surveillance n'a pas pu etre mise en place
+     *
+     */
+    int m_inotify_fd;
+
+    /**
+     * @brief Descripteur eventfd permettant de réveiller le thread lors de la destruction
+     *
+     */
+    int m_stop_fd;
+
+    /**
+     * @brief Thread de surveillance
+     *
+     */
+    std::thread m_thread;
+
+    /**
+     * @brief Boucle principale du thread de surveillance
+     *
+     */
+    void run();
+
+  public:
+    /**
+     * @brief Charge immédiatement la configuration, puis surveille ses modifications
+     *
+     * @param logger Logger auquel appliquer la configuration
+     * @param path Chemin du fichier de configuration
+     */
+    ConfigWatcher(Logger &logger, std::string path);
+
+    ConfigWatcher(ConfigWatcher const &) = delete;
+    ConfigWatcher &operator=(ConfigWatcher const &) = delete;
+
+    /**
+     * @brief Arrete la surveillance
+     *
+     */
+    ~ConfigWatcher();
+
+    /**
+     * @brief Recharge manuellement la configuration
+     *
+     * @return true Si le fichier a pu etre lu et appliqué
+     */
+    bool reload();
+  };
+}   // namespace tscl
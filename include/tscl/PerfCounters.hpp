@@ -0,0 +1,250 @@
+#pragma once
+#include "Logger.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace tscl {
+
+  /**
+   * @brief Compteurs de performance du thread courant (perf_event_open), mesurés autour d'une section
+   * comme avec un Chrono
+   *
+   * Les compteurs matériels forment un groupe, et les compteurs logiciels un autre, pour etre
+   * programmés ensemble. Lorsque le noyau multiplexe les compteurs, les valeurs sont extrapolées au
+   * temps d'activation. Sans PMU (conteneur, machine virtuelle) seuls les compteurs logiciels sont
+   * disponibles, et sans perf_event_open ils sont lus via getrusage et l'horloge CPU du thread
+   *
+   * Les compteurs suivent le thread ayant construit l'objet, qui ne doit etre utilisé que par lui
+   *
+   */
+  class PerfCounters {
+  public:
+    enum counter_t {
+      Cycles,
+      Instructions,
+      CacheMisses,
+      BranchMisses,
+      ContextSwitches,
+      PageFaults,
+      /**
+       * @brief Temps CPU du thread, en nanosecondes
+       *
+       */
+      CpuTime,
+      counter_count
+    };
+
+    /**
+     * @brief Source des compteurs ouverts
+     *
+     */
+    enum source_t {
+      /**
+       * @brief Compteurs matériels et logiciels du noyau
+       *
+       */
+      Hardware,
+      /**
+       * @brief Compteurs logiciels du noyau uniquement
+       *
+       */
+      Software,
+      /**
+       * @brief getrusage et horloge CPU du thread, sans perf_event_open
+       *
+       */
+      Fallback
+    };
+
+    /**
+     * @brief Valeurs mesurées sur une section
+     *
+     */
+    struct Sample {
+      std::chrono::duration<double> wall{0};
+      uint64_t values[counter_count] = {};
+
+      /**
+       * @brief Compteurs disponibles, bit i pour le compteur i
+       *
+       */
+      uint32_t available = 0;
+
+      /**
+       * @brief Temps pendant lequel le groupe matériel était activé, et réellement programmé sur la
+       * PMU. Le second est plus petit si le noyau a multiplexé les compteurs
+       *
+       */
+      uint64_t time_enabled = 0;
+      uint64_t time_running = 0;
+
+      bool has(counter_t counter) const noexcept { return available & (1u << counter); }
+      uint64_t operator[](counter_t counter) const noexcept { return values[counter]; }
+
+      /**
+       * @brief Part du temps pendant laquelle les compteurs matériels ont réellement compté
+       *
+       */
+      double coverage() const noexcept { return time_enabled ? double(time_running) / time_enabled : 1; }
+
+      Sample &operator+=(Sample const &other) noexcept;
+
+      /**
+       * @brief Différence entre deux lectures. Les compteurs matériels sont extrapolés au temps
+       * d'activation s'ils ont été multiplexés entre les deux
+       *
+       */
+      Sample operator-(Sample const &other) const noexcept;
+
+      /**
+       * @brief Ajoute les valeurs disponibles a la fin d'un string, au format
+       * "1.234ms | cycles 1234 | instructions 2345 (1.90 IPC) | ..."
+       *
+       * @param out String de sortie
+       */
+      void format(std::string &out) const;
+    };
+
+    /**
+     * @brief Nom d'un compteur, au format de perf ("cycles", "cache-misses", ...)
+     *
+     */
+    static std::string_view counterName(counter_t counter) noexcept;
+
+  private:
+    /**
+     * @brief Descripteurs des compteurs, -1 si le compteur n'est pas ouvert
+     *
+     */
+    int m_fds[counter_count];
+
+    /**
+     * @brief Groupes matériel et logiciel : meneur, et compteurs dans l'ordre de lecture
+     *
+     */
+    struct Group {
+      int leader = -1;
+      counter_t members[counter_count];
+      size_t size = 0;
+    };
+
+    Group m_groups[2];
+    source_t m_source;
+
+    Sample m_start;
+    Sample m_total;
+    bool m_paused;
+
+    void open();
+    bool openGroup(Group &group, counter_t first, counter_t last);
+
+  public:
+    /**
+     * @brief Ouvre les compteurs du thread courant et démarre la mesure
+     *
+     */
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(PerfCounters const &) = delete;
+    PerfCounters &operator=(PerfCounters const &) = delete;
+
+    /**
+     * @brief Compteurs du thread courant, ouverts a la premiere utilisation puis réutilisés. Evite
+     * d'ouvrir les compteurs pour chaque section mesurée
+     *
+     * @return PerfCounters&
+     */
+    static PerfCounters &thisThread();
+
+    source_t source() const noexcept { return m_source; }
+
+    /**
+     * @brief Lit la valeur brute de tout les compteurs. Seule la différence entre deux lectures a
+     * un sens
+     *
+     * @return Sample
+     */
+    Sample snapshot() const noexcept;
+
+    /**
+     * @brief Relance la mesure si elle est en pause
+     *
+     * @return PerfCounters&
+     */
+    PerfCounters &resume() noexcept;
+
+    /**
+     * @brief Met la mesure en pause
+     *
+     * @return PerfCounters&
+     */
+    PerfCounters &pause() noexcept;
+
+    /**
+     * @brief Réinitialise la mesure et la relance
+     *
+     * @return PerfCounters&
+     */
+    PerfCounters &restart() noexcept;
+
+    /**
+     * @brief Retourne les valeurs mesurées, hors pauses
+     *
+     * @return Sample
+     */
+    Sample get() noexcept;
+  };
+
+  /**
+   * @brief Log affichant les compteurs mesurés sur une section
+   *
+   */
+  class PerfLog : public Log {
+  private:
+    std::string m_section;
+    PerfCounters::Sample m_sample;
+
+    virtual std::string messageImpl() const override;
+
+  public:
+    PerfLog(std::string_view section, PerfCounters::Sample const &sample, Log::log_level level = Log::Debug);
+
+    PerfCounters::Sample const &sample() const noexcept { return m_sample; }
+  };
+
+  /**
+   * @brief Mesure les compteurs du thread courant jusqu'a la fin de la portée, puis les envoie au
+   * Logger sous forme de PerfLog
+   *
+   */
+  class ScopedCounters {
+  private:
+    Logger &m_logger;
+    std::string_view m_section;
+    Log::log_level m_level;
+
+    /**
+     * @brief Faux si aucun gestionnaire n'accepte le niveau : les compteurs ne sont alors pas lus
+     *
+     */
+    bool m_enabled;
+    PerfCounters::Sample m_start;
+
+  public:
+    /**
+     * @param section Nom de la section, doit rester valide jusqu'a la fin de la portée
+     * @param level Niveau du log envoyé
+     * @param logger Logger destinataire
+     */
+    explicit ScopedCounters(std::string_view section, Log::log_level level = Log::Debug,
+                            Logger &logger = Logger::singleton());
+    ~ScopedCounters();
+
+    ScopedCounters(ScopedCounters const &) = delete;
+    ScopedCounters &operator=(ScopedCounters const &) = delete;
+  };
+}   // namespace tscl
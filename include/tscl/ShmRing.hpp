@@ -0,0 +1,305 @@
+#pragma once
+#include "Logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tscl {
+
+  /**
+   * @brief Anneau de logs stocké dans un segment de mémoire partagée POSIX
+   *
+   * Plusieurs processus (et plusieurs threads) peuvent écrire dans le meme anneau sans verrou :
+   * chaque écrivain réserve un emplacement a l'aide d'un compteur atomique, puis le publie en mettant
+   * a jour la séquence de l'emplacement. Un unique collecteur lit les emplacements publiés. Les logs
+   * publiés restent dans le segment si l'écrivain s'arrete brutalement
+   *
+   */
+  class ShmRing {
+  public:
+    /**
+     * @brief Valeur identifiant un segment initialisé
+     *
+     */
+    static constexpr uint64_t magic = 0x7473636c726e6735;   // "tsclrng5"
+
+    /**
+     * @brief En-tete du segment
+     *
+     */
+    struct Header {
+      std::atomic<uint64_t> magic;
+      uint32_t slot_size;
+      uint32_t slot_count;
+
+      /**
+       * @brief Prochaine position a réserver par un écrivain
+       *
+       */
+      alignas(64) std::atomic<uint64_t> write_index;
+
+      /**
+       * @brief Prochaine position a lire par le collecteur
+       *
+       */
+      alignas(64) std::atomic<uint64_t> read_index;
+
+      /**
+       * @brief Nombre de logs abandonnés par les écrivains faute de place
+       *
+       */
+      std::atomic<uint64_t> dropped;
+    };
+
+    /**
+     * @brief En-tete d'un emplacement, suivi des données du log
+     *
+     */
+    struct Slot {
+      /**
+       * @brief Vaut la position de l'emplacement lorsqu'il est libre, et la position + 1 une fois publié.
+       * Le collecteur peut reprendre un emplacement dont l'écrivain est mort en le passant a la
+       * position suivante : la publication se fait donc par compare_exchange, et échoue dans ce cas
+       *
+       */
+      std::atomic<uint64_t> sequence;
+
+      /**
+       * @brief Ecrivain ayant réservé l'emplacement : 32 bits de poids faible de la position, puis
+       * pid. Ecrit avant la copie du log, pour que le collecteur puisse vérifier qu'il est en vie
+       *
+       */
+      std::atomic<uint64_t> owner;
+
+      /**
+       * @brief Identité du log dans son processus : date de capture et thread
+       *
+       */
+      uint64_t timestamp;
+      uint32_t pid;
+      uint32_t tid;
+      uint16_t prefix_size;
+      uint16_t message_size;
+      uint8_t level;
+      uint8_t truncated;
+
+      char *data() noexcept { return reinterpret_cast<char *>(this + 1); }
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory rings require lock-free atomics");
+
+  private:
+    /**
+     * @brief Nom du segment
+     *
+     */
+    std::string m_name;
+
+    /**
+     * @brief Adresse du segment
+     *
+     */
+    Header *m_header;
+
+    /**
+     * @brief Taille du segment
+     *
+     */
+    size_t m_size;
+
+    ShmRing(std::string name, Header *header, size_t size);
+
+  public:
+    ShmRing(ShmRing const &) = delete;
+    ShmRing &operator=(ShmRing const &) = delete;
+    ShmRing(ShmRing &&other) noexcept;
+    ShmRing &operator=(ShmRing &&other) noexcept;
+
+    /**
+     * @brief Détache le segment, sans le supprimer
+     *
+     */
+    ~ShmRing();
+
+    /**
+     * @brief Ouvre un anneau, en le créant s'il n'existe pas encore
+     *
+     * @param name Nom du segment, commencant par '/'
+     * @param slot_count Nombre d'emplacements, arrondi a la puissance de deux supérieure
+     * @param slot_size Taille d'un emplacement, en-tete compris
+     * @return std::optional<ShmRing> L'anneau, ou std::nullopt en cas d'erreur
+     */
+    static std::optional<ShmRing> create(std::string const &name, size_t slot_count = 4096, size_t slot_size = 512);
+
+    /**
+     * @brief Ouvre un anneau existant
+     *
+     * @param name Nom du segment
+     * @return std::optional<ShmRing> L'anneau, ou std::nullopt s'il n'existe pas ou n'est pas initialisé
+     */
+    static std::optional<ShmRing> open(std::string const &name);
+
+    /**
+     * @brief Supprime un segment. Les processus l'ayant déja ouvert peuvent continuer a l'utiliser
+     *
+     * @param name Nom du segment
+     */
+    static void unlink(std::string const &name);
+
+    std::string const &name() const noexcept { return m_name; }
+    Header &header() noexcept { return *m_header; }
+
+    /**
+     * @brief Retourne l'emplacement correspondant a une position
+     *
+     * @param index Position dans l'anneau
+     * @return Slot&
+     */
+    Slot &slot(uint64_t index) noexcept;
+
+    /**
+     * @brief Taille maximum des données d'un log
+     *
+     */
+    size_t capacity() const noexcept { return m_header->slot_size - sizeof(Slot); }
+
+    /**
+     * @brief Ecrit un log dans l'anneau, sans verrou ni appel systeme
+     *
+     * @param level Niveau du log
+     * @param stamp Identité du log
+     * @param prefix Catégorie et contexte du log
+     * @param message Message du log
+     * @return true Si le log a été écrit, false si l'anneau est plein
+     */
+    bool push(Log::log_level level, LogStamp const &stamp, std::string_view prefix, std::string_view message) noexcept;
+  };
+
+  /**
+   * @brief Gestionnaire écrivant les logs dans un anneau en mémoire partagée, a destination d'un
+   * ShmRingCollector
+   *
+   */
+  class ShmRingLogHandler : public LogHandler {
+  private:
+    /**
+     * @brief Anneau de destination
+     *
+     */
+    ShmRing m_ring;
+
+  public:
+    /**
+     * @brief Ouvre ou crée l'anneau
+     *
+     * @param name Nom du segment, commencant par '/'
+     * @param slot_count Nombre d'emplacements
+     * @param slot_size Taille d'un emplacement
+     * @throw std::runtime_error Si le segment n'a pas pu etre ouvert
+     */
+    ShmRingLogHandler(std::string const &name, size_t slot_count = 4096, size_t slot_size = 512);
+
+    /**
+     * @brief Ecrit le log dans l'anneau. Le log est abandonné si l'anneau est plein
+     *
+     * @param log
+     */
+    virtual void log(Log const &log, std::string const &message) override;
+
+    /**
+     * @brief Nombre de logs abandonnés faute de place, tout écrivains confondus
+     *
+     * @return size_t
+     */
+    size_t dropped() { return m_ring.header().dropped.load(std::memory_order_relaxed); }
+  };
+
+  /**
+   * @brief Collecteur vidant un ou plusieurs anneaux dans les gestionnaires d'un Logger
+   *
+   * Les logs des différents anneaux sont fusionnés par date de capture, ceux d'un meme anneau restant
+   * dans l'ordre de leur réservation. Les gestionnaires du Logger numérotent les logs qu'ils écrivent :
+   * les logs perdus dans les anneaux sont comptés par lost() et ShmRingLogHandler::dropped()
+   *
+   */
+  class ShmRingCollector {
+  public:
+    /**
+     * @brief Durée au dela de laquelle le collecteur vérifie si l'écrivain d'un emplacement réservé
+     * mais jamais publié est toujours en vie. L'emplacement n'est repris que si l'écrivain est mort :
+     * un écrivain seulement ralenti écraserait sinon le log suivant
+     *
+     */
+    static constexpr std::chrono::milliseconds stall_timeout{1000};
+
+    /**
+     * @brief Durée au dela de laquelle un emplacement réservé dont l'écrivain n'a pas encore été
+     * enregistré est repris (écrivain arreté entre la réservation et l'enregistrement de son pid)
+     *
+     */
+    static constexpr std::chrono::milliseconds orphan_timeout{10000};
+
+  private:
+    /**
+     * @brief Etat de lecture d'un anneau
+     *
+     */
+    struct Source {
+      ShmRing ring;
+      std::chrono::steady_clock::time_point stalled_since;
+      bool stalled = false;
+    };
+
+    /**
+     * @brief Logger recevant les logs collectés
+     *
+     */
+    Logger &m_logger;
+
+    /**
+     * @brief Anneaux surveillés
+     *
+     */
+    std::vector<Source> m_sources;
+
+    /**
+     * @brief Nombre d'emplacements abandonnés car jamais publiés
+     *
+     */
+    size_t m_lost;
+
+    /**
+     * @brief Retourne l'emplacement en tete d'un anneau s'il est publié
+     *
+     * @param source L'anneau
+     * @return ShmRing::Slot* L'emplacement, ou nullptr si aucun log n'est disponible
+     */
+    ShmRing::Slot *head(Source &source);
+
+  public:
+    explicit ShmRingCollector(Logger &logger = Logger::singleton());
+
+    /**
+     * @brief Ajoute un anneau existant a la liste des anneaux collectés
+     *
+     * @param name Nom du segment
+     * @return true Si l'anneau a pu etre ouvert
+     */
+    bool attach(std::string const &name);
+
+    /**
+     * @brief Transmet au Logger tout les logs actuellement publiés
+     *
+     * @return size_t Le nombre de logs transmis
+     */
+    size_t poll();
+
+    /**
+     * @brief Nombre d'emplacements perdus a cause d'un écrivain arreté pendant l'écriture
+     *
+     */
+    size_t lost() const noexcept { return m_lost; }
+  };
+}   // namespace tscl
@@ -0,0 +1,235 @@
+#pragma once
+#include "Logger.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <thread>
+
+namespace tscl {
+
+  /**
+   * @brief Gestionnaire envoyant les logs a un collecteur local au travers d'un socket AF_UNIX
+   *
+   * Les logs sont mis en file par log(), puis envoyés par lots par un thread dédié (un seul appel a
+   * sendmmsg ou sendmsg par lot). Tant que le collecteur est indisponible, les logs sont conservés
+   * dans un tampon de taille bornée, et la connexion est retentée avec un délai croissant. Si le
+   * tampon est plein, les logs les plus anciens sont abandonnés
+   *
+   */
+  class UnixSocketLogHandler : public LogHandler {
+  public:
+    /**
+     * @brief Type de socket a utiliser
+     *
+     */
+    enum class socket_t {
+      /**
+       * @brief Un datagramme par log
+       *
+       */
+      Datagram,
+      /**
+       * @brief Flux de logs séparés par des retours a la ligne
+       *
+       */
+      Stream
+    };
+
+    /**
+     * @brief Nombre maximum de logs envoyés en un seul appel systeme
+     *
+     */
+    static constexpr size_t max_batch = 64;
+
+    /**
+     * @brief Délai minimum entre deux tentatives de connexion
+     *
+     */
+    static constexpr std::chrono::milliseconds min_backoff{10};
+
+    /**
+     * @brief Délai maximum entre deux tentatives de connexion
+     *
+     */
+    static constexpr std::chrono::milliseconds max_backoff{5000};
+
+    /**
+     * @brief Durée maximum d'attente de flush() lorsque le collecteur ne lit plus
+     *
+     */
+    static constexpr std::chrono::milliseconds flush_timeout{1000};
+
+  private:
+    /**
+     * @brief Chemin du socket du collecteur
+     *
+     */
+    std::string m_path;
+
+    /**
+     * @brief Type du socket
+     *
+     */
+    socket_t m_type;
+
+    /**
+     * @brief Descripteur du socket, -1 si non connecté
+     *
+     */
+    int m_fd;
+
+    /**
+     * @brief Logs en attente d'envoi, déja formatés
+     *
+     */
+    std::deque<std::string> m_spool;
+
+    /**
+     * @brief Fin d'un log dont le début a déja été transmis sur la connexion courante. Elle est
+     * envoyée avant tout autre log, et n'est jamais soumise a l'abandon des logs les plus anciens
+     *
+     */
+    std::string m_partial;
+
+    /**
+     * @brief Taille totale des logs en attente
+     *
+     */
+    size_t m_spool_size;
+
+    /**
+     * @brief Taille maximum du tampon, en octets
+     *
+     */
+    size_t m_spool_capacity;
+
+    /**
+     * @brief Nombre de logs en cours d'envoi par le thread dédié
+     *
+     */
+    size_t m_in_flight;
+
+    /**
+     * @brief Nombre de logs abandonnés : faute de place dans le tampon, trop grands pour un
+     * datagramme, interrompus par la perte de la connexion, ou restant a l'arret
+     *
+     */
+    std::atomic<size_t> m_dropped;
+
+    /**
+     * @brief Vrai si le collecteur est actuellement joignable
+     *
+     */
+    std::atomic<bool> m_connected;
+
+    /**
+     * @brief Vrai lorsque le thread dédié doit s'arreter
+     *
+     */
+    bool m_stop;
+
+    /**
+     * @brief Signale l'arrivée de nouveaux logs, ou la demande d'arret
+     *
+     */
+    std::condition_variable_any m_pending;
+
+    /**
+     * @brief Signale que le thread dédié a terminé un envoi
+     *
+     */
+    std::condition_variable_any m_sent;
+
+    /**
+     * @brief Thread d'envoi
+     *
+     */
+    std::thread m_thread;
+
+    /**
+     * @brief Boucle principale du thread d'envoi
+     *
+     */
+    void run();
+
+    /**
+     * @brief Tente d'ouvrir le socket et de se connecter au collecteur
+     *
+     * @return true Si la connexion a réussi
+     */
+    bool connect();
+
+    /**
+     * @brief Ferme le socket courant
+     *
+     */
+    void disconnect();
+
+    /**
+     * @brief Envoie un lot de logs
+     *
+     * @param batch Les logs a envoyer. Si l'envoi s'arrete au milieu d'un log, celui ci est tronqué
+     * de la partie déja transmise
+     * @param count Nombre de logs a envoyer
+     * @param blocked Vaut vrai en sortie si l'envoi s'est arreté car le socket était plein
+     * @param partial Vaut vrai en sortie si le premier log non envoyé l'a été en partie
+     * @return size_t Le nombre de logs entierement envoyés
+     */
+    size_t send(std::string *batch, size_t count, bool &blocked, bool &partial);
+
+    /**
+     * @brief Ajoute un log au tampon, en abandonnant les plus anciens si nécessaire.
+     * m_main_mutex doit etre verrouillé
+     *
+     * @param record Le log formaté
+     * @param front Vrai pour remettre un log en tete de file
+     */
+    void spool(std::string &&record, bool front);
+
+  public:
+    /**
+     * @brief Construit le handler, et démarre le thread d'envoi
+     *
+     * @param path Chemin du socket du collecteur
+     * @param type Type de socket a utiliser
+     * @param spool_capacity Taille maximum du tampon, en octets
+     */
+    UnixSocketLogHandler(std::string path, socket_t type = socket_t::Datagram,
+                         size_t spool_capacity = 4 * 1024 * 1024);
+
+    /**
+     * @brief Envoie les logs en attente si le collecteur est joignable, puis arrete le thread
+     *
+     */
+    ~UnixSocketLogHandler();
+
+    /**
+     * @brief Formate le log et le place dans le tampon d'envoi
+     *
+     * @param log
+     */
+    virtual void log(Log const &log, std::string const &message) override;
+
+    /**
+     * @brief Attend l'envoi des logs en attente, tant que le collecteur est joignable et au plus
+     * flush_timeout
+     *
+     */
+    virtual void flush() override;
+
+    /**
+     * @brief Getter pour le nombre de logs abandonnés
+     *
+     * @return size_t
+     */
+    size_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Indique si le collecteur est actuellement joignable
+     *
+     * @return true Si le socket est connecté
+     */
+    bool connected() const { return m_connected.load(std::memory_order_relaxed); }
+  };
+}   // namespace tscl
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace tscl {
+
+  /**
+   * @brief Pile d'appels capturée sous forme d'adresses brutes
+   *
+   * La capture ne fait que parcourir la pile, sans allocation ni résolution de symboles. Les
+   * symboles ne sont résolus qu'au moment de l'affichage (dladdr et démangling), avec un cache par
+   * adresse partagé par tout les threads
+   *
+   */
+  class StackTrace {
+  public:
+    /**
+     * @brief Nombre maximum de niveaux capturés
+     *
+     */
+    static constexpr size_t max_frames = 32;
+
+  private:
+    void *m_frames[max_frames];
+    size_t m_size;
+
+  public:
+    constexpr StackTrace() noexcept : m_frames(), m_size(0) {}
+
+    /**
+     * @brief Capture la pile d'appels du thread courant
+     *
+     * @param skip Nombre de niveaux a ignorer, en plus de capture() elle meme
+     * @return StackTrace La pile capturée
+     */
+    [[gnu::noinline]] static StackTrace capture(size_t skip = 0) noexcept;
+
+    std::span<void *const> frames() const noexcept { return {m_frames, m_size}; }
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    /**
+     * @brief Résout les symboles et ajoute la pile a la fin d'un string, un niveau par ligne. Chaque
+     * ligne commence par prefix
+     *
+     * Format d'une ligne : "#1 fonction+0x1a (module)", ou "#1 module+0x4f2a" lorsque le symbole est
+     * inconnu (fonction statique, binaire lié sans -rdynamic). L'adresse relative au module peut
+     * alors etre passée a addr2line
+     *
+     * @param out String de sortie
+     * @param prefix Texte précédant chaque ligne
+     */
+    void render(std::string &out, std::string_view prefix = "\n") const;
+  };
+}   // namespace tscl
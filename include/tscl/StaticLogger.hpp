@@ -0,0 +1,368 @@
+#pragma once
+#include "Logger.hpp"
+#include <atomic>
+#include <cerrno>
+#include <concepts>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <poll.h>
+#include <unistd.h>
+
+/**
+ * Pipelines de logs composés a la compilation
+ *
+ * Les filtres, formateurs et sorties sont des types, assemblés par StaticLogger<Sink...>. Aucun
+ * appel virtuel ni dynamic_cast n'est nécessaire entre l'envoi du log et son écriture, le compilateur
+ * peut donc tout inliner. Les niveaux et le comportement des logs Fatal sont ceux du Logger dynamique,
+ * avec lequel un StaticLogger peut cohabiter (voir LoggerSink)
+ *
+ */
+namespace tscl {
+
+  /**
+   * @brief Concept décrivant une sortie utilisable par StaticLogger
+   *
+   */
+  template<typename TSink>
+  concept StaticSink = requires(TSink &sink, TSink const &csink, Log const &log, std::string const &message) {
+    { csink.accepts(Log::Trace) } -> std::convertible_to<bool>;
+    sink.write(log, message);
+  };
+
+  /**
+   * @brief Concept décrivant un formateur, transformant un log en ligne de texte. Chaque sortie
+   * possede son propre formateur, qui peut donc avoir un état (voir StampedFormatter)
+   *
+   */
+  template<typename TFormatter>
+  concept StaticFormatter = requires(TFormatter &formatter, std::string &out, Log const &log,
+                                     std::string const &message) {
+    formatter.format(out, log, message);
+  };
+
+  // ==================================================================
+  // ===                         Formatters                         ===
+  // ==================================================================
+
+  /**
+   * @brief Formateur par défaut : préfixe, message puis retour a la ligne
+   *
+   * @tparam TsType Type de timestamp a utiliser
+   */
+  template<timestamp_t TsType = timestamp_t::None>
+  struct PlainFormatter {
+    static void format(std::string &out, Log const &log, std::string const &message) {
+      log.appendPrefix(out, TsType);
+      out += message;
+      out += '\n';
+    }
+  };
+
+  /**
+   * @brief Formateur ajoutant les codes couleurs ascii autour d'un autre formateur
+   *
+   * @tparam TFormatter Formateur a colorer
+   */
+  template<StaticFormatter TFormatter = PlainFormatter<>>
+  struct ColorFormatter {
+    static constexpr std::string_view colors[] = {"\033[39;90m", "\033[39;36m", "\033[39;34m",
+                                                  "\033[39;33m", "\033[39;31m", "\033[39;35m"};
+
+    [[no_unique_address]] TFormatter formatter;
+
+    void format(std::string &out, Log const &log, std::string const &message) {
+      out += colors[log.level()];
+      formatter.format(out, log, message);
+      out += "\033[0m";
+    }
+  };
+
+  /**
+   * @brief Formateur ajoutant le numéro de séquence et le thread du log devant un autre formateur.
+   * Les logs sont numérotés par la sortie qui les écrit, comme par un LogHandler
+   *
+   * @tparam TFormatter Formateur a compléter
+   */
+  template<StaticFormatter TFormatter = PlainFormatter<>>
+  struct StampedFormatter {
+    std::atomic<uint64_t> sequence{0};
+    [[no_unique_address]] TFormatter formatter;
+
+    void format(std::string &out, Log const &log, std::string const &message) {
+      LogStamp stamp = log.stamp();
+      stamp.sequence = sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+      stamp.render(out);
+      formatter.format(out, log, message);
+    }
+  };
+
+  // ==================================================================
+  // ===                         Sinks                              ===
+  // ==================================================================
+
+  /**
+   * @brief Filtre ne laissant passer que les logs d'un niveau supérieur ou égal a MinLevel
+   *
+   * @tparam MinLevel Niveau minimum, connu a la compilation
+   * @tparam TSink Sortie filtrée
+   */
+  template<Log::log_level MinLevel, StaticSink TSink>
+  class LevelFilter {
+  private:
+    TSink m_sink;
+
+  public:
+    template<typename... Args>
+    explicit LevelFilter(Args &&...args) : m_sink(std::forward<Args>(args)...) {}
+
+    bool accepts(Log::log_level level) const noexcept { return level >= MinLevel and m_sink.accepts(level); }
+
+    void write(Log const &log, std::string const &message) { m_sink.write(log, message); }
+
+    TSink &sink() noexcept { return m_sink; }
+  };
+
+  /**
+   * @brief Sortie vers un descripteur de fichier, un seul appel a write par log
+   *
+   * @tparam TFormatter Formateur a utiliser
+   */
+  template<StaticFormatter TFormatter = PlainFormatter<>>
+  class FdSink {
+  private:
+    int m_fd;
+    [[no_unique_address]] TFormatter m_formatter;
+
+  public:
+    explicit FdSink(int fd = STDOUT_FILENO) noexcept : m_fd(fd) {}
+
+    bool accepts(Log::log_level) const noexcept { return true; }
+
+    void write(Log const &log, std::string const &message) {
+      // Le tampon est réutilisé d'un log a l'autre, pour ne pas allouer a chaque appel
+      thread_local std::string buffer;
+      buffer.clear();
+      m_formatter.format(buffer, log, message);
+
+      // Reprend apres une écriture partielle ou une interruption, comme ConsoleLogHandler
+      size_t written = 0;
+      while (written < buffer.size()) {
+        ssize_t res = ::write(m_fd, buffer.data() + written, buffer.size() - written);
+
+        if (res < 0) {
+          if (errno == EINTR) continue;
+
+          // Sortie non bloquante : attend qu'elle soit de nouveau disponible
+          if (errno == EAGAIN or errno == EWOULDBLOCK) {
+            pollfd pfd{m_fd, POLLOUT, 0};
+            if (poll(&pfd, 1, -1) >= 0 or errno == EINTR) continue;
+          }
+
+          return;
+        }
+
+        written += res;
+      }
+    }
+  };
+
+  /**
+   * @brief Sortie vers un flux standard, protégé par un mutex
+   *
+   * @tparam TFormatter Formateur a utiliser
+   */
+  template<StaticFormatter TFormatter = PlainFormatter<>>
+  class OStreamSink {
+  private:
+    std::ostream *m_out;
+    std::mutex m_mutex;
+    [[no_unique_address]] TFormatter m_formatter;
+
+  public:
+    explicit OStreamSink(std::ostream &out = std::cout) noexcept : m_out(&out) {}
+
+    bool accepts(Log::log_level) const noexcept { return true; }
+
+    void write(Log const &log, std::string const &message) {
+      thread_local std::string buffer;
+      buffer.clear();
+      m_formatter.format(buffer, log, message);
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_out->write(buffer.data(), buffer.size());
+    }
+  };
+
+  /**
+   * @brief Sortie transmettant les logs a un Logger dynamique, pour cohabiter avec ses gestionnaires
+   *
+   */
+  class LoggerSink {
+  private:
+    Logger *m_logger;
+
+  public:
+    explicit LoggerSink(Logger &target = Logger::singleton()) noexcept : m_logger(&target) {}
+
+    bool accepts(Log::log_level level) const noexcept { return m_logger->accepts(level); }
+
+    void write(Log const &log, std::string const &) { (*m_logger)(log); }
+  };
+
+  // ==================================================================
+  // ===                         StaticLogger                       ===
+  // ==================================================================
+
+  /**
+   * @brief Logger dont l'ensemble des sorties est fixé a la compilation
+   *
+   * @tparam TSinks Sorties, dans l'ordre dans lequel elles recoivent les logs
+   */
+  template<StaticSink... TSinks>
+  class StaticLogger {
+  private:
+    /**
+     * @brief Emplacement de la sortie d'index I. Une sortie protégée par un mutex, ou numérotant ses
+     * logs, n'est pas déplacable : elle est construite en place a partir de ses arguments
+     *
+     */
+    template<size_t I, typename TSink>
+    struct Slot {
+      TSink sink;
+
+      Slot() = default;
+
+      template<typename TArgs>
+      Slot(std::in_place_t, TArgs &&args) : sink(std::make_from_tuple<TSink>(std::forward<TArgs>(args))) {}
+    };
+
+    template<typename TIndexes>
+    struct Sinks;
+
+    template<size_t... Is>
+    struct Sinks<std::index_sequence<Is...>> : Slot<Is, TSinks>... {
+      Sinks() = default;
+
+      template<typename... TArgs>
+      explicit Sinks(std::in_place_t, TArgs &&...args)
+          : Slot<Is, TSinks>(std::in_place, std::forward<TArgs>(args))... {}
+    };
+
+    using indexes = std::index_sequence_for<TSinks...>;
+
+    template<size_t I>
+    using sink_t = std::tuple_element_t<I, std::tuple<TSinks...>>;
+
+    Sinks<indexes> m_sinks;
+
+    [[noreturn]] static void fatal() {
+      std::cout << "\n\nThe application has encountered a fatal error and must close.\n";
+      exit(1);
+    }
+
+  public:
+    StaticLogger() = default;
+
+    /**
+     * @brief Construit le logger a partir de sorties déja construites, si elles sont déplacables
+     *
+     * @param sinks Les sorties
+     */
+    explicit StaticLogger(TSinks... sinks)
+      requires(std::move_constructible<TSinks> and ...)
+        : m_sinks(std::in_place, std::forward_as_tuple(std::move(sinks))...) {}
+
+    /**
+     * @brief Construit chaque sortie en place, a partir d'un tuple d'arguments. Par exemple
+     * StaticLogger<OStreamSink<>, FdSink<>> l(std::in_place, std::forward_as_tuple(std::cerr),
+     * std::make_tuple(STDERR_FILENO))
+     *
+     * @param args Arguments du constructeur de chaque sortie, dans l'ordre des sorties
+     */
+    template<typename... TArgs>
+      requires(sizeof...(TArgs) == sizeof...(TSinks))
+    explicit StaticLogger(std::in_place_t, TArgs &&...args) : m_sinks(std::in_place, std::forward<TArgs>(args)...) {}
+
+    StaticLogger(StaticLogger const &) = delete;
+    StaticLogger &operator=(StaticLogger const &) = delete;
+
+    /**
+     * @brief Indique si au moins une sortie acceptera un log du niveau donné
+     *
+     * @param level Niveau du log
+     * @return true Si une sortie accepte ce niveau
+     */
+    bool accepts(Log::log_level level) const noexcept {
+      return [&]<size_t... Is>(std::index_sequence<Is...>) {
+        return (sink<Is>().accepts(level) or ...);
+      }(indexes());
+    }
+
+    /**
+     * @brief Envoie un log a toutes les sorties l'acceptant
+     *
+     * @param log Le log a envoyer
+     * @return StaticLogger&
+     */
+    StaticLogger &operator()(Log const &log) noexcept {
+      if (accepts(log.level())) {
+        log.capture();
+        std::string msg = log.message();
+
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+          ((sink<Is>().accepts(log.level()) ? sink<Is>().write(log, msg) : void()), ...);
+        }(indexes());
+      }
+
+      if (log.level() == Log::Fatal) fatal();
+
+      return *this;
+    }
+
+    /**
+     * @brief Envoie un message a toutes les sorties l'acceptant
+     *
+     * @param msg Le message
+     * @param level Niveau du message
+     * @return StaticLogger&
+     */
+    StaticLogger &operator()(std::string_view msg, Log::log_level level = Log::Trace) noexcept {
+      if (not accepts(level) and level != Log::Fatal) return *this;
+
+      return operator()(StringLog(msg, level));
+    }
+
+    /**
+     * @brief Envoie un message construit a la demande
+     *
+     * @param func Callable produisant le message
+     * @param level Niveau du message
+     * @return StaticLogger&
+     */
+    template<LazyMessage TFunc>
+    StaticLogger &operator()(TFunc &&func, Log::log_level level = Log::Trace) noexcept {
+      return operator()(LazyLog<std::decay_t<TFunc>>(std::forward<TFunc>(func), level));
+    }
+
+    /**
+     * @brief Retourne une sortie a partir de son index
+     *
+     * @tparam I Index de la sortie
+     * @return La sortie
+     */
+    template<size_t I>
+    auto &sink() noexcept {
+      return static_cast<Slot<I, sink_t<I>> &>(m_sinks).sink;
+    }
+
+    template<size_t I>
+    auto const &sink() const noexcept {
+      return static_cast<Slot<I, sink_t<I>> const &>(m_sinks).sink;
+    }
+  };
+}   // namespace tscl
@@ -11,11 +11,11 @@
 namespace tscl {
 
   /**
-   * @brief variable statique correspondant au début du programme
+   * @brief Début du programme. Défini une seule fois dans la bibliotheque, et initialisé avant les
+   * autres variables globales
    *
    */
-  static const inline std::chrono::high_resolution_clock::time_point program_start =
-          std::chrono::high_resolution_clock::now();
+  extern std::chrono::high_resolution_clock::time_point const program_start;
 
   /**
    * @brief Enumeration de tout les types de timestamp disponible
@@ -41,7 +41,13 @@ namespace tscl {
      * @brief Renvoie la date complete, au format  Jour-Mois-Année Heures:Minutes:Secondes
      *
      */
-    Full
+    Full,
+    /**
+     * @brief Renvoie la date complete a la nanoseconde pres, au format
+     * Jour-Mois-Année Heures:Minutes:Secondes.nanosecondes
+     *
+     */
+    Precise
   };
 
   /**
@@ -52,6 +58,15 @@ namespace tscl {
    */
   std::string timestamp(timestamp_t tst);
 
+  /**
+   * @brief Ajoute un timestamp formatté correspondant a une date donnée a la fin d'un string
+   *
+   * @param out String de sortie
+   * @param tst Type de timestamp a utilisé
+   * @param time La date a formatter
+   */
+  void appendTimestamp(std::string &out, timestamp_t tst, std::chrono::system_clock::time_point time);
+
   /**
    * @brief Classe utilitaire représentant un chronometre
    *
@@ -3,8 +3,17 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <charconv>
+#include <compare>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 
 namespace tscl {
@@ -16,21 +25,60 @@ namespace tscl {
   public:
     static Version const &current;
 
+    /**
+     * @brief Composants d'une version analysée, sans allocation. tweak pointe dans la chaine d'origine
+     *
+     */
+    struct Parts {
+      size_t major = 0, minor = 0, patch = 0;
+      std::string_view tweak;
+
+      constexpr uint64_t key() const noexcept { return makeKey(major, minor, patch, tweak); }
+    };
+
     Version() { *this = current; }
 
-    Version(std::string const &version);
+    /**
+     * @brief Construit une version a partir d'une chaine au format [v]major[.minor[.patch[.tweak]]]
+     *
+     * @throw std::invalid_argument Si la chaine n'est pas une version valide
+     */
+    Version(std::string_view version);
     Version(size_t major, size_t minor, size_t patch, size_t tweak = 0);
     Version(size_t major, size_t minor, size_t patch, std::string tweak = "");
 
     static void setCurrent(Version const &version) { _current = version; }
 
-    bool operator==(const Version &other) const {
-      return major_ver == other.major_ver && minor_ver == other.minor_ver && patch_ver == other.patch_ver;
-    }
+    /**
+     * @brief Analyse une version au format [v]major[.minor[.patch[.tweak]]], sans allocation.
+     * Les composants absents valent 0, le tweak peut aussi etre séparé par '-' ou '+'
+     *
+     * @return std::optional<Parts> Les composants, ou std::nullopt si la chaine est invalide
+     */
+    static constexpr std::optional<Parts> parse(std::string_view str) noexcept;
+
+    /**
+     * @brief Clé de 64 bits respectant l'ordre des versions : 16 bits par composant. Un composant
+     * trop grand est saturé et masque les suivants, et tout les tweaks non numériques partagent la
+     * meme clé : une version inférieure a une autre n'a jamais une clé plus grande, mais des versions
+     * différentes peuvent partager une clé et doivent alors etre départagées par operator<=>
+     *
+     */
+    static constexpr uint64_t makeKey(size_t major, size_t minor, size_t patch, std::string_view tweak) noexcept;
+
+    /**
+     * @brief Compare deux tweaks : numériquement si les deux sont numériques, lexicographiquement
+     * sinon. Un tweak vide est inférieur a un tweak numérique, lui meme inférieur a un tweak non
+     * numérique
+     *
+     */
+    static constexpr std::strong_ordering compareTweak(std::string_view lhs, std::string_view rhs) noexcept;
+
+    [[nodiscard]] uint64_t key() const noexcept { return makeKey(major_ver, minor_ver, patch_ver, tweak); }
+
+    bool operator==(const Version &other) const { return (*this <=> other) == 0; }
 
-    bool operator!=(const Version &other) const { return not(*this == other); }
-    bool operator<(const Version &other) const;
-    bool operator>(const Version &other) const;
+    std::strong_ordering operator<=>(const Version &other) const;
 
     [[nodiscard]] size_t getMajor() const { return major_ver; }
     void setMajor(size_t m) { major_ver = m; }
@@ -55,5 +103,181 @@ namespace tscl {
   private:
     size_t major_ver, minor_ver, patch_ver;
     std::string tweak;
+
+    static constexpr std::optional<size_t> parseNumber(std::string_view &str) noexcept;
+  };
+
+  constexpr std::optional<size_t> Version::parseNumber(std::string_view &str) noexcept {
+    size_t res = 0;
+
+    if (std::is_constant_evaluated()) {
+      size_t i = 0;
+      for (; i < str.size() and str[i] >= '0' and str[i] <= '9'; i++) res = res * 10 + (str[i] - '0');
+
+      if (i == 0) return std::nullopt;
+      str.remove_prefix(i);
+      return res;
+    }
+
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), res);
+    if (ec != std::errc()) return std::nullopt;
+
+    str.remove_prefix(ptr - str.data());
+    return res;
+  }
+
+  constexpr std::optional<Version::Parts> Version::parse(std::string_view str) noexcept {
+    Parts res;
+
+    if (str.starts_with('v')) str.remove_prefix(1);
+
+    size_t *fields[] = {&res.major, &res.minor, &res.patch};
+    for (size_t *field : fields) {
+      auto number = parseNumber(str);
+      if (not number) return std::nullopt;
+      *field = *number;
+
+      if (str.empty()) return res;
+
+      // Le tweak est le reste de la chaine, et peut suivre n'importe quel composant
+      if (str.front() == '-' or str.front() == '+') {
+        res.tweak = str.substr(1);
+        return res;
+      }
+
+      if (str.front() != '.') return std::nullopt;
+      str.remove_prefix(1);
+    }
+
+    res.tweak = str;
+    return res;
+  }
+
+  constexpr uint64_t Version::makeKey(size_t major, size_t minor, size_t patch, std::string_view tweak) noexcept {
+    constexpr uint64_t max = 0xFFFF;
+
+    // Un composant saturé masque les suivants, sans quoi 65535.9 aurait une clé supérieure a 65536.0
+    if (major >= max) return max << 48;
+    if (minor >= max) return uint64_t(major) << 48 | max << 32;
+    if (patch >= max) return uint64_t(major) << 48 | uint64_t(minor) << 32 | max << 16;
+
+    // Tweak vide : 0, numérique : 1 a 0xFFFE, non numérique : 0xFFFF
+    uint64_t tweak_key = 0;
+    for (char c : tweak) {
+      if (c < '0' or c > '9') {
+        tweak_key = 0xFFFF;
+        break;
+      }
+      tweak_key = std::min<uint64_t>(tweak_key * 10 + (c - '0'), 0xFFFD);
+    }
+    if (not tweak.empty() and tweak_key != 0xFFFF) tweak_key++;
+
+    return uint64_t(major) << 48 | uint64_t(minor) << 32 | uint64_t(patch) << 16 | tweak_key;
+  }
+
+  constexpr std::strong_ordering Version::compareTweak(std::string_view lhs, std::string_view rhs) noexcept {
+    // Un tweak vide est inférieur a un tweak numérique, lui meme inférieur a un tweak non numérique
+    auto rank = [](std::string_view str) {
+      if (str.empty()) return 0;
+      for (char c : str)
+        if (c < '0' or c > '9') return 2;
+      return 1;
+    };
+
+    int lhs_rank = rank(lhs), rhs_rank = rank(rhs);
+    if (lhs_rank != rhs_rank) return lhs_rank <=> rhs_rank;
+
+    if (lhs_rank == 1) {
+      // Les zéros non significatifs sont ignorés, un nombre plus long est alors plus grand
+      while (lhs.size() > 1 and lhs.front() == '0') lhs.remove_prefix(1);
+      while (rhs.size() > 1 and rhs.front() == '0') rhs.remove_prefix(1);
+      if (lhs.size() != rhs.size()) return lhs.size() <=> rhs.size();
+    }
+
+    return lhs.compare(rhs) <=> 0;
+  }
+
+  /**
+   * @brief Intervalle de versions, chaque borne pouvant etre absente, incluse ou exclue
+   *
+   */
+  struct VersionRange {
+    struct Bound {
+      Version version;
+      bool inclusive;
+    };
+
+    /**
+     * @brief Bornes de l'intervalle, std::nullopt si l'intervalle n'est pas borné de ce coté
+     *
+     */
+    std::optional<Bound> lower, upper;
+
+    /**
+     * @brief Analyse une contrainte du type ">=1.2 <2", chaque terme étant combiné par intersection.
+     * Opérateurs supportés : >=, >, <=, <, = (ou version seule)
+     *
+     * @return std::optional<VersionRange> L'intervalle, ou std::nullopt si la contrainte est invalide
+     */
+    static std::optional<VersionRange> parse(std::string_view constraint);
+
+    /**
+     * @brief Clés des bornes, utilisées pour la recherche dans un VersionSet. Une version de meme clé
+     * qu'une borne doit encore etre comparée a la borne elle meme
+     *
+     */
+    uint64_t lowerKey() const noexcept { return lower ? lower->version.key() : 0; }
+    uint64_t upperKey() const noexcept { return upper ? upper->version.key() : UINT64_MAX; }
+
+    bool aboveLower(Version const &version) const noexcept;
+    bool belowUpper(Version const &version) const noexcept;
+
+    bool contains(Version const &version) const noexcept { return aboveLower(version) and belowUpper(version); }
+    bool empty() const noexcept;
+  };
+
+  /**
+   * @brief Ensemble de versions trié par clé, permettant de répondre aux requetes par intervalle
+   * par recherche dichotomique
+   *
+   */
+  class VersionSet {
+  private:
+    /**
+     * @brief Versions triées par clé, puis par operator<=> entre versions de meme clé
+     *
+     */
+    std::vector<Version> m_versions;
+
+    /**
+     * @brief Clés des versions, dans le meme ordre, parcourues lors des recherches
+     *
+     */
+    std::vector<uint64_t> m_keys;
+
+  public:
+    VersionSet() = default;
+
+    /**
+     * @brief Construit l'ensemble en une seule fois, a privilégier pour un grand nombre de versions
+     *
+     */
+    VersionSet(std::vector<Version> versions);
+
+    void insert(Version version);
+    size_t size() const noexcept { return m_versions.size(); }
+
+    /**
+     * @brief Retourne les versions contenues dans l'intervalle, triées par ordre croissant
+     *
+     */
+    std::span<Version const> satisfying(VersionRange const &range) const;
+
+    /**
+     * @brief Retourne la plus grande version contenue dans l'intervalle
+     *
+     * @return Version const* La version, ou nullptr si aucune version ne convient
+     */
+    Version const *maxSatisfying(VersionRange const &range) const;
   };
 }   // namespace tscl
\ No newline at end of file
@@ -1,5 +1,20 @@
 
 #pragma once
+#include "AsyncLogger.hpp"
+#include "Compression.hpp"
+#include "ConsoleLogHandler.hpp"
+#include "LockProfile.hpp"
+#include "LogBuffer.hpp"
+#include "LogContext.hpp"
+#include "LogIndex.hpp"
+#include "LogRouter.hpp"
+#include "LogStamp.hpp"
 #include "Logger.hpp"
+#include "LoggerConfig.hpp"
+#include "PerfCounters.hpp"
+#include "ShmRing.hpp"
+#include "SocketLogHandler.hpp"
+#include "StackTrace.hpp"
+#include "StaticLogger.hpp"
 #include "Time.hpp"
 #include "Version.hpp"
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "AsyncLogger.hpp"
+#include <algorithm>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace tscl {
+
+  namespace {
+    /**
+     * @brief Log reconstruit a partir d'un Record, le message est transmis a part
+     *
+     */
+    class RecordLog : public Log {
+    private:
+      long m_error_code;
+
+      virtual std::string messageImpl() const override { return {}; }
+
+    public:
+      explicit RecordLog(AsyncBackend::Record const &record) : Log(record.level, record.stamp), m_error_code(record.error_code) {
+        category(record.category);
+        context(&record.context);
+        origin(record.origin.view());
+      }
+
+      virtual long errorCode() const override { return m_error_code; }
+    };
+
+    /**
+     * @brief Indique au processeur que le thread est en attente active
+     *
+     */
+    inline void cpuRelax() noexcept {
+#if defined(__x86_64__) or defined(__i386__)
+      __builtin_ia32_pause();
+#elif defined(__aarch64__)
+      asm volatile("yield");
+#endif
+    }
+  }   // namespace
+
+  void AsyncBackend::Completion::complete() {
+    if (handle) {
+      if (resumer) resumer(handle);
+      else
+        handle.resume();
+    }
+
+    if (done) {
+      done->store(true, std::memory_order_release);
+      done->notify_all();
+    }
+  }
+
+  std::shared_ptr<std::atomic<bool>> AsyncBackend::Completion::makeFlag() noexcept {
+    try {
+      return std::make_shared<std::atomic<bool>>(false);
+    } catch (std::bad_alloc const &) { return nullptr; }
+  }
+
+  AsyncBackend::AsyncBackend(Logger &logger, BackendConfig const &config)
+      : m_logger(logger), m_queue(config.capacity), m_deferring(false), m_stop(false), m_signal(0), m_sleeping(false),
+        m_wait(config.wait), m_spin(config.spin), m_yield(config.yield), m_batch(std::max<size_t>(config.batch, 1)),
+        m_spin_budget(config.spin), m_thread(&AsyncBackend::run, this) {
+    configure(config);
+  }
+
+  AsyncBackend::~AsyncBackend() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+
+    wake(true);
+    m_thread.join();
+  }
+
+  bool AsyncBackend::configure(BackendConfig const &config) {
+    m_wait.store(config.wait, std::memory_order_relaxed);
+    m_spin.store(config.spin, std::memory_order_relaxed);
+    m_yield.store(config.yield, std::memory_order_relaxed);
+    m_batch.store(std::max<size_t>(config.batch, 1), std::memory_order_relaxed);
+
+    // Le backend peut etre endormi avec l'ancienne stratégie
+    wake(true);
+
+    bool res = true;
+    pthread_t thread = m_thread.native_handle();
+
+    if (config.cpu >= 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+
+      if (config.cpu < CPU_SETSIZE) CPU_SET(config.cpu, &set);
+
+      if (config.cpu >= CPU_SETSIZE or pthread_setaffinity_np(thread, sizeof(set), &set) != 0) {
+        m_logger(ErrorLog("Cannot pin logging backend to CPU " + std::to_string(config.cpu),
+                          errors::ERR_THREAD_SETUP_FAILURE, Log::Warning));
+        res = false;
+      }
+    }
+
+    if (pthread_setname_np(thread, config.name.substr(0, 15).c_str()) != 0) {
+      m_logger(ErrorLog("Cannot name logging backend \"" + config.name + "\"", errors::ERR_THREAD_SETUP_FAILURE,
+                        Log::Warning));
+      res = false;
+    }
+
+    return res;
+  }
+
+  AsyncBackend::Record AsyncBackend::makeRecord(Log const &log) {
+    thread_local std::string buffer;
+    buffer.clear();
+    log.appendMessage(buffer);
+
+    Record res;
+    res.level = log.level();
+    res.category = log.category();
+    res.error_code = log.errorCode();
+    res.stamp = log.stamp();
+    if (log.context()) res.context = *log.context();
+    res.origin.assign(log.origin());
+    res.message.assign(buffer);
+    if (auto *trace = log.stackTrace()) res.trace = *trace;
+    return res;
+  }
+
+  bool AsyncBackend::tryPush(Record &record) {
+    if (m_deferring.load(std::memory_order_acquire) or not m_queue.tryPush(record)) return false;
+
+    wake();
+    return true;
+  }
+
+  bool AsyncBackend::pushOrDefer(Record &record, std::optional<Completion> completion) {
+    if (tryPush(record)) return false;
+
+    bool deferred = completion.has_value();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_overflow.push_back({std::move(record), std::move(completion)});
+      m_deferring.store(true, std::memory_order_release);
+    }
+
+    wake(true);
+    return deferred;
+  }
+
+  void AsyncBackend::flush(Completion completion) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_requests.push_back({Request::Flush, {}, std::move(completion)});
+    }
+
+    wake(true);
+  }
+
+  void AsyncBackend::removeHandler(std::string name, Completion completion) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_requests.push_back({Request::RemoveHandler, std::move(name), std::move(completion)});
+    }
+
+    wake(true);
+  }
+
+  void AsyncBackend::resumer(Resumer resumer) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_resumer = std::move(resumer);
+  }
+
+  Resumer AsyncBackend::resumer() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_resumer;
+  }
+
+  bool AsyncBackend::onBackendThread() const noexcept { return std::this_thread::get_id() == m_thread.get_id(); }
+
+  void AsyncBackend::wake(bool force) {
+    // Le producteur publie son log avant de lire m_sleeping, le backend fait l'inverse : l'un des deux
+    // voit forcément l'écriture de l'autre
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Seul le premier producteur trouvant le backend endormi le réveille
+    if (not force and not (m_sleeping.load(std::memory_order_relaxed) and m_sleeping.exchange(false)))
+      return;
+
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+  }
+
+  void AsyncBackend::dispatch(Record &record) {
+    // Les gestionnaires recoivent un std::string, dont la capacité est conservée d'un log a l'autre
+    thread_local std::string buffer;
+    buffer.assign(record.message.view());
+    record.trace.render(buffer, ErrorLog::indent);
+
+    RecordLog log(record);
+    m_logger.dispatch(log, buffer);
+  }
+
+  size_t AsyncBackend::drain(size_t limit) {
+    size_t count = 0;
+
+    while (count < limit) {
+      Record *record = m_queue.front();
+      if (not record) break;
+
+      dispatch(*record);
+      // Libere la mémoire du message avant de rendre l'emplacement
+      *record = Record();
+      m_queue.pop();
+      count++;
+    }
+
+    return count;
+  }
+
+  void AsyncBackend::run() {
+    std::vector<Request> requests;
+    std::deque<Overflow> overflow;
+
+    while (true) {
+      uint32_t signal = m_signal.load(std::memory_order_acquire);
+
+      // Les demandes sont relevées avant de vider la file, et gardées tant qu'elle n'est pas vide :
+      // tout log envoyé avant une demande est donc écrit avant qu'elle ne soit traitée
+      bool stop;
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (requests.empty()) requests.swap(m_requests);
+        overflow.swap(m_overflow);
+        stop = m_stop;
+      }
+
+      // Les logs de la file précedent ceux mis de coté : elle est vidée entierement avant eux. Elle
+      // ne recoit plus de nouveaux logs tant que m_deferring est vrai
+      size_t limit = overflow.empty() ? m_batch.load(std::memory_order_relaxed) : SIZE_MAX;
+      size_t count = drain(limit);
+      bool drained = count < limit;
+
+      if (not overflow.empty()) {
+        for (auto &i : overflow) {
+          dispatch(i.record);
+          if (i.completion) i.completion->complete();
+        }
+        count += overflow.size();
+        overflow.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_overflow.empty()) m_deferring.store(false, std::memory_order_release);
+      }
+
+      if (drained) {
+        for (auto &i : requests) {
+          if (i.kind == Request::Flush) m_logger.flushHandlers();
+          else
+            m_logger.eraseHandler(i.name);
+
+          i.completion.complete();
+        }
+        count += requests.size();
+        requests.clear();
+      }
+
+      if (stop) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (requests.empty() and m_requests.empty() and m_overflow.empty() and m_queue.empty()) return;
+        continue;
+      }
+
+      if (not count) idle(signal);
+    }
+  }
+
+  void AsyncBackend::idle(uint32_t signal) {
+    auto ready = [&]() {
+      return m_signal.load(std::memory_order_acquire) != signal or not m_queue.empty();
+    };
+
+    auto wait = m_wait.load(std::memory_order_relaxed);
+    uint32_t spin = m_spin.load(std::memory_order_relaxed);
+
+    // Pour Park, l'attente active s'allonge tant qu'elle suffit, et raccourcit sinon
+    uint32_t budget = wait == BackendConfig::Park ? std::min(m_spin_budget, spin) : spin;
+
+    for (uint32_t i = 0; i < budget or wait == BackendConfig::Spin; i++) {
+      if (ready()) {
+        m_spin_budget = std::min(spin, std::max<uint32_t>(budget * 2, 16));
+        return;
+      }
+
+      cpuRelax();
+    }
+
+    uint32_t yield = m_yield.load(std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < yield or wait == BackendConfig::Yield; i++) {
+      if (ready()) return;
+      std::this_thread::yield();
+    }
+
+    m_spin_budget = budget / 2;
+
+    m_sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_queue.empty()) m_signal.wait(signal, std::memory_order_acquire);
+
+    m_sleeping.store(false, std::memory_order_relaxed);
+  }
+
+}   // namespace tscl
@@ -0,0 +1,348 @@
+#include "Compression.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace tscl {
+
+  namespace lz {
+    namespace {
+      constexpr size_t min_match = 4;
+
+      /**
+       * @brief Les 5 derniers octets sont toujours des littéraux, et la derniere correspondance
+       * commence au moins 12 octets avant la fin (contraintes du format LZ4)
+       *
+       */
+      constexpr size_t last_literals = 5;
+      constexpr size_t match_find_limit = 12;
+
+      constexpr size_t hash_bits = 12;
+      constexpr size_t max_offset = 65535;
+
+      uint32_t read32(char const *ptr) noexcept {
+        uint32_t res;
+        std::memcpy(&res, ptr, sizeof(res));
+        return res;
+      }
+
+      uint32_t hash(uint32_t value) noexcept { return (value * 2654435761u) >> (32 - hash_bits); }
+
+      char *writeLength(char *op, size_t length) noexcept {
+        while (length >= 255) {
+          *op++ = char(255);
+          length -= 255;
+        }
+        *op++ = char(length);
+        return op;
+      }
+
+      char *writeSequence(char *op, char const *literals, size_t literal_size, size_t offset,
+                          size_t match_size) noexcept {
+        char *token = op++;
+        *token = char(std::min<size_t>(literal_size, 15) << 4);
+
+        if (literal_size >= 15) op = writeLength(op, literal_size - 15);
+        std::memcpy(op, literals, literal_size);
+        op += literal_size;
+
+        // Derniere séquence : uniquement des littéraux
+        if (not match_size) return op;
+
+        *op++ = char(offset & 0xff);
+        *op++ = char(offset >> 8);
+
+        match_size -= min_match;
+        *token |= char(std::min<size_t>(match_size, 15));
+        if (match_size >= 15) op = writeLength(op, match_size - 15);
+
+        return op;
+      }
+
+      bool readLength(char const *&ip, char const *end, size_t &length) noexcept {
+        uint8_t byte;
+        do {
+          if (ip == end) return false;
+          byte = uint8_t(*ip++);
+          length += byte;
+        } while (byte == 255);
+        return true;
+      }
+    }   // namespace
+
+    size_t compress(std::span<char const> src, char *dst) noexcept {
+      char const *base = src.data();
+      size_t size = src.size();
+      char *op = dst;
+      size_t anchor = 0;
+
+      if (size >= match_find_limit + 1) {
+        int32_t table[1 << hash_bits];
+        std::fill(std::begin(table), std::end(table), -1);
+
+        size_t match_limit = size - last_literals;
+        size_t ip = 0;
+        size_t misses = 0;
+
+        while (ip + match_find_limit < size) {
+          uint32_t sequence = read32(base + ip);
+          uint32_t h = hash(sequence);
+          int32_t ref = table[h];
+          table[h] = int32_t(ip);
+
+          if (ref < 0 or ip - ref > max_offset or read32(base + ref) != sequence) {
+            // Les zones sans correspondance sont parcourues de plus en plus vite
+            ip += 1 + (misses++ >> 6);
+            continue;
+          }
+          misses = 0;
+
+          size_t match_size = min_match;
+          while (ip + match_size < match_limit and base[ref + match_size] == base[ip + match_size]) match_size++;
+
+          op = writeSequence(op, base + anchor, ip - anchor, ip - ref, match_size);
+          ip += match_size;
+          anchor = ip;
+        }
+      }
+
+      op = writeSequence(op, base + anchor, size - anchor, 0, 0);
+      return op - dst;
+    }
+
+    bool decompress(std::span<char const> src, std::span<char> dst) noexcept {
+      char const *ip = src.data();
+      char const *end = ip + src.size();
+      char *op = dst.data();
+      char *op_end = op + dst.size();
+
+      while (ip < end) {
+        uint8_t token = uint8_t(*ip++);
+
+        size_t literal_size = token >> 4;
+        if (literal_size == 15 and not readLength(ip, end, literal_size)) return false;
+        if (literal_size > size_t(end - ip) or literal_size > size_t(op_end - op)) return false;
+
+        std::memcpy(op, ip, literal_size);
+        ip += literal_size;
+        op += literal_size;
+
+        if (ip == end) break;
+
+        if (end - ip < 2) return false;
+        size_t offset = uint8_t(ip[0]) | (size_t(uint8_t(ip[1])) << 8);
+        ip += 2;
+
+        size_t match_size = token & 15;
+        if (match_size == 15 and not readLength(ip, end, match_size)) return false;
+        match_size += min_match;
+
+        if (offset == 0 or offset > size_t(op - dst.data()) or match_size > size_t(op_end - op)) return false;
+
+        // Les zones peuvent se chevaucher, la copie se fait octet par octet
+        char const *match = op - offset;
+        for (size_t i = 0; i < match_size; i++) op[i] = match[i];
+        op += match_size;
+      }
+
+      return op == op_end;
+    }
+  }   // namespace lz
+
+  namespace frame {
+    uint32_t checksum(std::span<char const> data) noexcept {
+      uint32_t res = 2166136261u;
+      for (char c : data) res = (res ^ uint8_t(c)) * 16777619u;
+      return res;
+    }
+  }   // namespace frame
+
+  CompressedStreamBuf::CompressedStreamBuf(std::string const &path, size_t block_size)
+      : m_file(path, std::ios::binary | std::ios::trunc),
+        m_block_size(std::clamp<size_t>(block_size, 4096, frame::uncompressed_flag - 1)), m_writing(0),
+        m_stop(false) {
+    frame::FileHeader header{};
+    std::copy(std::begin(frame::magic), std::end(frame::magic), header.magic);
+    header.version = frame::version;
+    header.block_size = m_block_size;
+
+    m_file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    m_file.flush();
+
+    m_current.reserve(m_block_size);
+    m_thread = std::thread(&CompressedStreamBuf::run, this);
+  }
+
+  CompressedStreamBuf::~CompressedStreamBuf() {
+    flush();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+
+    m_pending_cv.notify_one();
+    m_thread.join();
+  }
+
+  void CompressedStreamBuf::submit() {
+    if (m_current.empty()) return;
+
+    m_pending.push_back(std::move(m_current));
+
+    if (m_free.empty()) m_current = std::string();
+    else {
+      m_current = std::move(m_free.back());
+      m_free.pop_back();
+    }
+
+    m_current.clear();
+    m_current.reserve(m_block_size);
+    m_pending_cv.notify_one();
+  }
+
+  std::streamsize CompressedStreamBuf::xsputn(char const *s, std::streamsize n) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::streamsize written = 0;
+
+    while (written < n) {
+      // Le thread de compression attend le premier octet d'un bloc pour en surveiller l'age
+      if (m_current.empty()) {
+        m_current_since = std::chrono::steady_clock::now();
+        m_pending_cv.notify_one();
+      }
+
+      size_t count = std::min<size_t>(n - written, m_block_size - m_current.size());
+      m_current.append(s + written, count);
+      written += count;
+
+      if (m_current.size() == m_block_size) {
+        // Le thread de compression est en retard : l'écrivain attend plutot que d'accumuler les blocs
+        m_done_cv.wait(lock, [this]() { return m_pending.size() < max_pending; });
+        submit();
+      }
+    }
+
+    return written;
+  }
+
+  CompressedStreamBuf::int_type CompressedStreamBuf::overflow(int_type c) {
+    if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+
+    char tmp = traits_type::to_char_type(c);
+    xsputn(&tmp, 1);
+    return c;
+  }
+
+  void CompressedStreamBuf::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    submit();
+    m_done_cv.wait(lock, [this]() { return m_pending.empty() and m_writing == 0; });
+  }
+
+  void CompressedStreamBuf::writeBlock(std::string const &block, std::vector<char> &buffer) {
+    buffer.resize(lz::compressBound(block.size()));
+    size_t size = lz::compress(block, buffer.data());
+
+    frame::BlockHeader header{uint32_t(size), uint32_t(block.size()), frame::checksum(block)};
+    char const *data = buffer.data();
+
+    // Les données incompressibles sont stockées telles quelles
+    if (size >= block.size()) {
+      header.compressed_size = uint32_t(block.size()) | frame::uncompressed_flag;
+      data = block.data();
+      size = block.size();
+    }
+
+    m_file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    m_file.write(data, size);
+    m_file.flush();
+  }
+
+  void CompressedStreamBuf::run() {
+    std::vector<char> buffer;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+      if (m_pending.empty()) {
+        if (m_stop) return;
+
+        if (m_current.empty()) m_pending_cv.wait(lock);
+        else if (std::chrono::steady_clock::now() - m_current_since >= max_delay) submit();
+        else
+          m_pending_cv.wait_until(lock, m_current_since + max_delay);
+
+        continue;
+      }
+
+      std::string block = std::move(m_pending.front());
+      m_pending.pop_front();
+      m_writing++;
+
+      lock.unlock();
+      writeBlock(block, buffer);
+      lock.lock();
+
+      m_writing--;
+      m_free.push_back(std::move(block));
+      m_done_cv.notify_all();
+    }
+  }
+
+  CompressedReader::CompressedReader(std::istream &in) : m_in(in), m_status(Ok) {
+    frame::FileHeader header{};
+    m_in.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    if (m_in.gcount() != sizeof(header) or not std::equal(std::begin(frame::magic), std::end(frame::magic), header.magic) or
+        header.version != frame::version)
+      m_status = InvalidHeader;
+  }
+
+  std::optional<std::span<char const>> CompressedReader::next() {
+    if (m_status != Ok) return std::nullopt;
+
+    frame::BlockHeader header{};
+    m_in.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    if (m_in.gcount() == 0) {
+      m_status = End;
+      return std::nullopt;
+    }
+
+    if (m_in.gcount() != sizeof(header)) {
+      m_status = Truncated;
+      return std::nullopt;
+    }
+
+    bool stored = header.compressed_size & frame::uncompressed_flag;
+    uint32_t size = header.compressed_size & ~frame::uncompressed_flag;
+
+    if (size > lz::compressBound(header.raw_size) or (stored and size != header.raw_size)) {
+      m_status = Corrupted;
+      return std::nullopt;
+    }
+
+    m_compressed.resize(size);
+    m_in.read(m_compressed.data(), size);
+
+    if (size_t(m_in.gcount()) != size) {
+      m_status = Truncated;
+      return std::nullopt;
+    }
+
+    m_block.resize(header.raw_size);
+
+    if (stored) m_block.swap(m_compressed);
+    else if (not lz::decompress(m_compressed, m_block)) {
+      m_status = Corrupted;
+      return std::nullopt;
+    }
+
+    if (frame::checksum(m_block) != header.checksum) {
+      m_status = Corrupted;
+      return std::nullopt;
+    }
+
+    return std::span<char const>(m_block);
+  }
+
+}   // namespace tscl
@@ -0,0 +1,81 @@
+#include "ConsoleLogHandler.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace tscl {
+
+  namespace {
+    bool supportsColor(int fd) {
+      if (not isatty(fd) or std::getenv("NO_COLOR")) return false;
+
+      char const *term = std::getenv("TERM");
+      return not term or std::strcmp(term, "dumb") != 0;
+    }
+
+    /**
+     * @brief Ecrit tout les tampons, en reprenant apres une écriture partielle ou une interruption
+     *
+     */
+    void writeAll(int fd, iovec *iov, int count) {
+      while (count > 0) {
+        ssize_t written = writev(fd, iov, count);
+
+        if (written < 0) {
+          if (errno == EINTR) continue;
+
+          // Sortie non bloquante : attend qu'elle soit de nouveau disponible
+          if (errno == EAGAIN or errno == EWOULDBLOCK) {
+            pollfd pfd{fd, POLLOUT, 0};
+            if (poll(&pfd, 1, -1) >= 0 or errno == EINTR) continue;
+          }
+
+          return;
+        }
+
+        while (count > 0 and size_t(written) >= iov->iov_len) {
+          written -= iov->iov_len;
+          iov++;
+          count--;
+        }
+
+        if (count > 0) {
+          iov->iov_base = static_cast<char *>(iov->iov_base) + written;
+          iov->iov_len -= written;
+        }
+      }
+    }
+  }   // namespace
+
+  ConsoleLogHandler::ConsoleLogHandler(stream_t stream, color_t color)
+      : m_fd(stream == stream_t::Stdout ? STDOUT_FILENO : STDERR_FILENO),
+        m_color(color == color_t::Always or (color == color_t::Auto and supportsColor(m_fd))) {}
+
+  void ConsoleLogHandler::log(Log const &log, std::string const &message) {
+    if (not accepts(log.level())) return;
+
+    thread_local std::string prefix;
+    prefix.clear();
+    appendHeader(prefix, log);
+
+    iovec iov[5];
+    int count = 0;
+    auto add = [&](std::string_view part) {
+      if (not part.empty()) iov[count++] = {const_cast<char *>(part.data()), part.size()};
+    };
+
+    if (m_color) add(ansi_colors[log.level()]);
+    add(prefix);
+    add(message);
+    if (m_color) add(ansi_reset);
+    add("\n");
+
+    // Le verrou garantit qu'une écriture partielle n'est pas entrecoupée par un autre log
+    std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+    writeAll(m_fd, iov, count);
+  }
+
+}   // namespace tscl
@@ -0,0 +1,213 @@
+#include "LockProfile.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <ctime>
+
+namespace tscl {
+
+  namespace {
+    uint64_t monotonicNow() noexcept {
+      timespec ts{};
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    size_t bucket(uint64_t ns) noexcept {
+      return std::min<size_t>(std::bit_width(ns), LockProfile::bucket_count - 1);
+    }
+
+    void storeMax(std::atomic<uint64_t> &max, uint64_t value) noexcept {
+      uint64_t current = max.load(std::memory_order_relaxed);
+      while (current < value and not max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t percentile(std::array<uint64_t, LockProfile::bucket_count> const &histogram, double q) noexcept {
+      uint64_t total = 0;
+      for (auto count : histogram) total += count;
+      if (not total) return 0;
+
+      uint64_t rank = std::min<uint64_t>(total - 1, uint64_t(q * total));
+      for (size_t i = 0; i < histogram.size(); i++) {
+        if (rank < histogram[i]) return uint64_t(1) << i;
+        rank -= histogram[i];
+      }
+
+      return uint64_t(1) << (LockProfile::bucket_count - 1);
+    }
+
+    /**
+     * @brief Dates d'acquisition en lecture du thread, la plus récente en dernier
+     *
+     */
+    struct SharedHolds {
+      static constexpr size_t capacity = 8;
+
+      ProfiledSharedMutex const *mutex[capacity] = {};
+      uint64_t since[capacity] = {};
+      size_t depth = 0;
+    };
+
+    constinit thread_local SharedHolds shared_holds;
+
+    void appendDuration(std::string &out, char const *name, uint64_t ns) {
+      char buffer[48];
+      if (ns < 10000) std::snprintf(buffer, sizeof(buffer), "%s %lluns", name, static_cast<unsigned long long>(ns));
+      else if (ns < 10000000)
+        std::snprintf(buffer, sizeof(buffer), "%s %.1fus", name, ns / 1e3);
+      else
+        std::snprintf(buffer, sizeof(buffer), "%s %.1fms", name, ns / 1e6);
+      out += buffer;
+    }
+  }   // namespace
+
+  uint64_t LockProfile::waitPercentile(double q) const noexcept { return percentile(wait_histogram, q); }
+
+  uint64_t LockProfile::holdPercentile(double q) const noexcept { return percentile(hold_histogram, q); }
+
+  std::string LockProfile::format() const {
+    std::string res = std::to_string(shared) + " shared, " + std::to_string(exclusive) + " exclusive";
+    if (not count()) return res;
+
+    appendDuration(res, ", hold p50 <", holdPercentile(0.5));
+    appendDuration(res, " p99 <", holdPercentile(0.99));
+    appendDuration(res, " p99.9 <", holdPercentile(0.999));
+    appendDuration(res, " max", max_hold);
+    appendDuration(res, ", wait p99 <", waitPercentile(0.99));
+    appendDuration(res, " max", max_wait);
+    appendDuration(res, " total", wait);
+
+    return res;
+  }
+
+  void ProfiledSharedMutex::recordWait(uint64_t begin, uint64_t end) noexcept {
+    uint64_t duration = end - begin;
+
+    m_counters.wait.fetch_add(duration, std::memory_order_relaxed);
+    m_counters.wait_histogram[bucket(duration)].fetch_add(1, std::memory_order_relaxed);
+    storeMax(m_counters.max_wait, duration);
+  }
+
+  void ProfiledSharedMutex::recordHold(uint64_t begin, uint64_t end) noexcept {
+    uint64_t duration = end - begin;
+
+    m_counters.hold.fetch_add(duration, std::memory_order_relaxed);
+    m_counters.hold_histogram[bucket(duration)].fetch_add(1, std::memory_order_relaxed);
+    storeMax(m_counters.max_hold, duration);
+  }
+
+  void ProfiledSharedMutex::lock() {
+    if (not profiling()) {
+      m_mutex.lock();
+      m_exclusive_since = 0;
+      return;
+    }
+
+    uint64_t begin = monotonicNow();
+    m_mutex.lock();
+    m_exclusive_since = monotonicNow();
+
+    m_counters.exclusive.fetch_add(1, std::memory_order_relaxed);
+    recordWait(begin, m_exclusive_since);
+  }
+
+  bool ProfiledSharedMutex::try_lock() {
+    if (not m_mutex.try_lock()) return false;
+
+    m_exclusive_since = profiling() ? monotonicNow() : 0;
+    if (m_exclusive_since) m_counters.exclusive.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void ProfiledSharedMutex::unlock() {
+    uint64_t since = m_exclusive_since;
+    uint64_t end = since ? monotonicNow() : 0;
+
+    m_mutex.unlock();
+    if (since) recordHold(since, end);
+  }
+
+  void ProfiledSharedMutex::lock_shared() {
+    if (not profiling()) {
+      m_mutex.lock_shared();
+      return;
+    }
+
+    uint64_t begin = monotonicNow();
+    m_mutex.lock_shared();
+    uint64_t end = monotonicNow();
+
+    m_counters.shared.fetch_add(1, std::memory_order_relaxed);
+    recordWait(begin, end);
+
+    auto &holds = shared_holds;
+    if (holds.depth < SharedHolds::capacity) {
+      holds.mutex[holds.depth] = this;
+      holds.since[holds.depth] = end;
+    }
+    holds.depth++;
+  }
+
+  bool ProfiledSharedMutex::try_lock_shared() {
+    if (not m_mutex.try_lock_shared()) return false;
+    if (not profiling()) return true;
+
+    m_counters.shared.fetch_add(1, std::memory_order_relaxed);
+
+    auto &holds = shared_holds;
+    if (holds.depth < SharedHolds::capacity) {
+      holds.mutex[holds.depth] = this;
+      holds.since[holds.depth] = monotonicNow();
+    }
+    holds.depth++;
+    return true;
+  }
+
+  void ProfiledSharedMutex::unlock_shared() {
+    auto &holds = shared_holds;
+
+    // Verrou pris sans profilage : aucune date n'a été empilée pour lui
+    if (not holds.depth or (holds.depth <= SharedHolds::capacity and holds.mutex[holds.depth - 1] != this)) {
+      m_mutex.unlock_shared();
+      return;
+    }
+
+    size_t top = --holds.depth;
+    uint64_t end = monotonicNow();
+    m_mutex.unlock_shared();
+
+    if (top < SharedHolds::capacity) recordHold(holds.since[top], end);
+  }
+
+  LockProfile ProfiledSharedMutex::profile() const noexcept {
+    LockProfile res;
+    res.shared = m_counters.shared.load(std::memory_order_relaxed);
+    res.exclusive = m_counters.exclusive.load(std::memory_order_relaxed);
+    res.wait = m_counters.wait.load(std::memory_order_relaxed);
+    res.max_wait = m_counters.max_wait.load(std::memory_order_relaxed);
+    res.hold = m_counters.hold.load(std::memory_order_relaxed);
+    res.max_hold = m_counters.max_hold.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < LockProfile::bucket_count; i++) {
+      res.wait_histogram[i] = m_counters.wait_histogram[i].load(std::memory_order_relaxed);
+      res.hold_histogram[i] = m_counters.hold_histogram[i].load(std::memory_order_relaxed);
+    }
+
+    return res;
+  }
+
+  void ProfiledSharedMutex::resetProfile() noexcept {
+    m_counters.shared.store(0, std::memory_order_relaxed);
+    m_counters.exclusive.store(0, std::memory_order_relaxed);
+    m_counters.wait.store(0, std::memory_order_relaxed);
+    m_counters.max_wait.store(0, std::memory_order_relaxed);
+    m_counters.hold.store(0, std::memory_order_relaxed);
+    m_counters.max_hold.store(0, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < LockProfile::bucket_count; i++) {
+      m_counters.wait_histogram[i].store(0, std::memory_order_relaxed);
+      m_counters.hold_histogram[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+}   // namespace tscl
@@ -0,0 +1,241 @@
+#include "LogBuffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace tscl {
+
+  namespace {
+    constexpr size_t class_count = std::size(LogBuffer::chunk_sizes);
+
+    /**
+     * @brief Nombre maximum de blocs conservés par taille, dans chaque thread et dans la réserve
+     *
+     */
+    constexpr size_t cache_limit = 16;
+    constexpr size_t depot_limit = 256;
+
+    /**
+     * @brief Emplacement de la réserve, contenant un bloc ou libre
+     *
+     */
+    struct Node {
+      /**
+       * @brief Index + 1 de l'emplacement suivant dans sa pile, 0 en fin de pile. Atomique car un
+       * thread peut le lire alors qu'un autre a déja dépilé l'emplacement
+       *
+       */
+      std::atomic<uint32_t> next;
+      char *chunk;
+    };
+
+    /**
+     * @brief Pile de Treiber d'emplacements. Le sommet contient l'index + 1 du premier emplacement
+     * (32 bits de poids faible) et un compteur de modifications (32 bits de poids fort) : un
+     * emplacement dépilé puis rempilé entre la lecture du sommet et le compare_exchange change le
+     * compteur, et fait donc échouer ce dernier (probleme ABA)
+     *
+     */
+    class Stack {
+    private:
+      std::atomic<uint64_t> m_head;
+
+      static uint64_t next(uint64_t head, uint32_t top) noexcept { return ((head >> 32) + 1) << 32 | top; }
+
+    public:
+      void push(Node *nodes, uint32_t index) noexcept {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+
+        do {
+          nodes[index].next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        } while (not m_head.compare_exchange_weak(head, next(head, index + 1), std::memory_order_release,
+                                                  std::memory_order_relaxed));
+      }
+
+      /**
+       * @brief Dépile un emplacement
+       *
+       * @return uint32_t Son index + 1, 0 si la pile est vide
+       */
+      uint32_t pop(Node *nodes) noexcept {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+
+        while (uint32_t top = static_cast<uint32_t>(head)) {
+          uint32_t following = nodes[top - 1].next.load(std::memory_order_relaxed);
+          if (m_head.compare_exchange_weak(head, next(head, following), std::memory_order_acquire,
+                                           std::memory_order_acquire))
+            return top;
+        }
+
+        return 0;
+      }
+    };
+
+    /**
+     * @brief Réserve commune, alimentée par les threads libérant plus de blocs qu'ils n'en allouent
+     * (typiquement le thread de fond du Logger), et accédée sans verrou
+     *
+     * Chaque taille possede depot_limit emplacements, répartis entre une pile d'emplacements
+     * remplis et une pile d'emplacements libres. Les emplacements ne sont jamais libérés : une
+     * lecture en retard de Node::next reste valide. Initialisée a zéro a la compilation, la réserve
+     * n'est jamais construite ni détruite, des blocs pouvant etre libérés pendant la destruction des
+     * variables statiques
+     *
+     */
+    struct Depot {
+      Node nodes[depot_limit];
+      Stack filled;
+      Stack empty;
+
+      /**
+       * @brief Nombre d'emplacements déja utilisés une fois, les suivants n'étant dans aucune pile
+       *
+       */
+      std::atomic<uint32_t> used;
+
+      bool push(char *chunk) noexcept {
+        uint32_t top = empty.pop(nodes);
+
+        if (not top and used.load(std::memory_order_relaxed) < depot_limit) {
+          uint32_t index = used.fetch_add(1, std::memory_order_relaxed);
+          if (index < depot_limit) top = index + 1;
+        }
+
+        if (not top) return false;
+
+        nodes[top - 1].chunk = chunk;
+        filled.push(nodes, top - 1);
+        return true;
+      }
+
+      char *pop() noexcept {
+        uint32_t top = filled.pop(nodes);
+        if (not top) return nullptr;
+
+        char *res = nodes[top - 1].chunk;
+        empty.push(nodes, top - 1);
+        return res;
+      }
+    };
+
+    constinit Depot depots[class_count] = {};
+
+    /**
+     * @brief Vrai une fois le cache du thread détruit, les blocs sont alors rendus a la réserve
+     *
+     */
+    constinit thread_local bool cache_destroyed = false;
+
+    /**
+     * @brief Cache de blocs propre a un thread, accédé sans verrou
+     *
+     */
+    struct Cache {
+      char *chunks[class_count][cache_limit];
+      size_t sizes[class_count] = {};
+
+      ~Cache() {
+        cache_destroyed = true;
+
+        for (size_t i = 0; i < class_count; i++)
+          while (sizes[i]) release(i, chunks[i][--sizes[i]]);
+      }
+
+      static void release(size_t size_class, char *chunk) noexcept {
+        if (not depots[size_class].push(chunk)) ::operator delete(chunk);
+      }
+    };
+
+    thread_local Cache cache;
+
+    size_t sizeClass(size_t capacity) noexcept {
+      return std::lower_bound(std::begin(LogBuffer::chunk_sizes), std::end(LogBuffer::chunk_sizes), capacity) -
+             std::begin(LogBuffer::chunk_sizes);
+    }
+  }   // namespace
+
+  char *LogBuffer::allocate(size_t size, uint32_t &capacity) {
+    size_t size_class = sizeClass(size + 1);
+
+    if (size_class == class_count) {
+      capacity = size;
+      return static_cast<char *>(::operator new(size + 1));
+    }
+
+    capacity = chunk_sizes[size_class] - 1;
+
+    if (not cache_destroyed and cache.sizes[size_class]) return cache.chunks[size_class][--cache.sizes[size_class]];
+
+    if (char *res = depots[size_class].pop()) return res;
+
+    return static_cast<char *>(::operator new(chunk_sizes[size_class]));
+  }
+
+  void LogBuffer::deallocate(char *data, uint32_t capacity) noexcept {
+    size_t size_class = sizeClass(capacity + 1);
+
+    if (size_class == class_count or chunk_sizes[size_class] != capacity + 1) {
+      ::operator delete(data);
+      return;
+    }
+
+    if (not cache_destroyed and cache.sizes[size_class] < cache_limit) {
+      cache.chunks[size_class][cache.sizes[size_class]++] = data;
+      return;
+    }
+
+    Cache::release(size_class, data);
+  }
+
+  void LogBuffer::reserve(size_t size) {
+    if (size <= m_capacity) return;
+
+    // Croissance géométrique, pour que les ajouts successifs restent en temps amorti constant
+    uint32_t capacity;
+    char *data = allocate(std::max<size_t>(size, size_t(m_capacity) * 2), capacity);
+    std::memcpy(data, m_data, m_size + 1);
+
+    if (not isInline()) deallocate(m_data, m_capacity);
+
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  LogBuffer::LogBuffer(LogBuffer &&other) noexcept : LogBuffer() { *this = std::move(other); }
+
+  LogBuffer &LogBuffer::operator=(LogBuffer const &other) {
+    if (this != &other) assign(other.view());
+    return *this;
+  }
+
+  LogBuffer &LogBuffer::operator=(LogBuffer &&other) noexcept {
+    if (this == &other) return *this;
+
+    if (other.isInline()) {
+      // Le stockage actuel est conservé, il peut toujours contenir une chaine courte
+      std::memcpy(m_data, other.m_data, other.m_size + 1);
+      m_size = other.m_size;
+    } else {
+      if (not isInline()) deallocate(m_data, m_capacity);
+
+      m_data = std::exchange(other.m_data, other.m_inline);
+      m_size = other.m_size;
+      m_capacity = std::exchange(other.m_capacity, inline_capacity);
+    }
+
+    other.clear();
+    return *this;
+  }
+
+  LogBuffer &LogBuffer::append(std::string_view str) {
+    reserve(m_size + str.size());
+
+    std::memcpy(m_data + m_size, str.data(), str.size());
+    m_size += str.size();
+    m_data[m_size] = '\0';
+    return *this;
+  }
+
+}   // namespace tscl
@@ -0,0 +1,45 @@
+#include "LogContext.hpp"
+
+namespace tscl {
+
+  namespace {
+    constinit thread_local LogContext thread_context;
+  }
+
+  LogContext &LogContext::current() noexcept { return thread_context; }
+
+  bool LogContext::push(std::string_view key, std::string_view value) noexcept {
+    if (m_size == max_fields) return false;
+
+    Field &field = m_fields[m_size++];
+
+    field.key_size = std::min(key.size(), max_key_size);
+    std::copy_n(key.data(), field.key_size, field.key_data);
+
+    field.value_size = std::min(value.size(), max_value_size);
+    std::copy_n(value.data(), field.value_size, field.value_data);
+
+    return true;
+  }
+
+  std::string_view LogContext::find(std::string_view key) const noexcept {
+    for (size_t i = m_size; i > 0; i--)
+      if (m_fields[i - 1].key() == key) return m_fields[i - 1].value();
+
+    return {};
+  }
+
+  void LogContext::render(std::string &out) const {
+    if (empty()) return;
+
+    out += " {";
+    for (size_t i = 0; i < m_size; i++) {
+      if (i) out += ' ';
+      out += m_fields[i].key();
+      out += '=';
+      out += m_fields[i].value();
+    }
+    out += '}';
+  }
+
+}   // namespace tscl
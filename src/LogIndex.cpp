@@ -0,0 +1,47 @@
+#include "LogIndex.hpp"
+#include <algorithm>
+
+namespace tscl {
+
+  LogIndexWriter::LogIndexWriter(std::string const &path, uint64_t offset, size_t max_records,
+                                 std::chrono::milliseconds max_duration)
+      : m_out(path, std::ios::binary | std::ios::trunc), m_max_records(std::max<size_t>(max_records, 1)),
+        m_max_duration(max_duration), m_offset(offset), m_current{}, m_latest(0) {
+    LogIndexHeader header{};
+    std::copy_n(LogIndexHeader::expected_magic, sizeof(header.magic), header.magic);
+    header.version = LogIndexHeader::current_version;
+    header.entry_size = sizeof(LogIndexEntry);
+
+    m_out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  }
+
+  LogIndexWriter::~LogIndexWriter() { flush(); }
+
+  void LogIndexWriter::record(size_t size, Log::log_level level, uint64_t timestamp) {
+    if (m_current.count == 0) {
+      m_current.offset = m_offset;
+      m_current.first_timestamp = timestamp;
+    }
+
+    m_latest = std::max(m_latest, timestamp);
+
+    m_current.first_timestamp = std::min(m_current.first_timestamp, timestamp);
+    m_current.last_timestamp = m_latest;
+    m_current.count++;
+    m_current.levels |= 1u << level;
+    m_offset += size;
+
+    if (m_current.count >= m_max_records or
+        std::chrono::nanoseconds(m_current.last_timestamp - m_current.first_timestamp) >= m_max_duration)
+      flush();
+  }
+
+  void LogIndexWriter::flush() {
+    if (m_current.count == 0) return;
+
+    m_out.write(reinterpret_cast<char const *>(&m_current), sizeof(m_current));
+    m_out.flush();
+    m_current = {};
+  }
+
+}   // namespace tscl
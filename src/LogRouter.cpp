@@ -0,0 +1,172 @@
+#include "LogRouter.hpp"
+#include <algorithm>
+#include <bit>
+#include <map>
+
+namespace tscl {
+
+  namespace {
+    template<typename TKey>
+    uint64_t findMask(std::vector<std::pair<TKey, uint64_t>> const &masks, auto const &key) noexcept {
+      auto it = std::lower_bound(masks.begin(), masks.end(), key,
+                                 [](auto const &entry, auto const &value) { return entry.first < value; });
+      return it != masks.end() and it->first == key ? it->second : 0;
+    }
+  }   // namespace
+
+  std::optional<LogRouter> LogRouter::compile(std::vector<LogRoute> const &routes) {
+    if (routes.size() > max_routes) return std::nullopt;
+
+    LogRouter res;
+    std::map<std::string, uint64_t, std::less<>> categories;
+    std::map<long, uint64_t> codes;
+
+    for (size_t i = 0; i < routes.size(); i++) {
+      auto const &route = routes[i];
+      uint64_t bit = uint64_t(1) << i;
+
+      auto handler = std::find(res.m_handlers.begin(), res.m_handlers.end(), route.handler);
+      if (handler == res.m_handlers.end()) handler = res.m_handlers.insert(handler, route.handler);
+      res.m_route_handlers.push_back(uint64_t(1) << (handler - res.m_handlers.begin()));
+
+      for (int level = route.min_level; level <= route.max_level; level++) res.m_by_level[level] |= bit;
+
+      if (route.categories.empty()) res.m_any_category |= bit;
+      for (auto const &name : route.categories) categories[name == "root" ? "" : name] |= bit;
+
+      if (route.error_codes.empty()) res.m_any_code |= bit;
+      for (long code : route.error_codes) codes[code] |= bit;
+    }
+
+    res.m_by_category.assign(categories.begin(), categories.end());
+    res.m_by_code.assign(codes.begin(), codes.end());
+    res.compileMessages(routes);
+
+    return res;
+  }
+
+  void LogRouter::compileMessages(std::vector<LogRoute> const &routes) {
+    constexpr uint32_t none = UINT32_MAX;
+
+    std::vector<std::pair<std::string_view, uint64_t>> patterns;
+
+    for (size_t i = 0; i < routes.size(); i++) {
+      uint64_t bit = uint64_t(1) << i;
+
+      // Un motif vide est contenu dans tout les messages
+      if (routes[i].contains.empty() or
+          std::any_of(routes[i].contains.begin(), routes[i].contains.end(), [](auto &p) { return p.empty(); }))
+        m_any_message |= bit;
+      else
+        for (auto const &pattern : routes[i].contains) patterns.emplace_back(pattern, bit);
+    }
+
+    if (patterns.empty()) return;
+
+    // Seuls les octets présents dans les motifs ont leur propre classe
+    for (auto const &[pattern, bit] : patterns)
+      for (char c : pattern)
+        if (not m_classes[uint8_t(c)]) m_classes[uint8_t(c)] = m_class_count++;
+
+    // Arbre des motifs
+    m_transitions.assign(m_class_count, none);
+    m_outputs.assign(1, 0);
+
+    for (auto const &[pattern, bit] : patterns) {
+      uint32_t state = 0;
+
+      for (char c : pattern) {
+        uint32_t &next = m_transitions[state * m_class_count + m_classes[uint8_t(c)]];
+
+        if (next == none) {
+          next = m_outputs.size();
+          m_transitions.resize(m_transitions.size() + m_class_count, none);
+          m_outputs.push_back(0);
+        }
+
+        state = m_transitions[state * m_class_count + m_classes[uint8_t(c)]];
+      }
+
+      m_outputs[state] |= bit;
+    }
+
+    // Parcours en largeur : calcul des liens d'échec, puis remplacement des transitions manquantes
+    // par celles de l'état d'échec, pour obtenir un automate sans retour arriere
+    std::vector<uint32_t> fail(m_outputs.size(), 0);
+    std::vector<uint32_t> queue;
+
+    for (size_t c = 0; c < m_class_count; c++) {
+      uint32_t &next = m_transitions[c];
+      if (next == none) next = 0;
+      else
+        queue.push_back(next);
+    }
+
+    for (size_t i = 0; i < queue.size(); i++) {
+      uint32_t state = queue[i];
+
+      for (size_t c = 0; c < m_class_count; c++) {
+        uint32_t &next = m_transitions[state * m_class_count + c];
+        uint32_t fallback = m_transitions[fail[state] * m_class_count + c];
+
+        if (next == none) next = fallback;
+        else {
+          fail[next] = fallback;
+          m_outputs[next] |= m_outputs[fallback];
+          queue.push_back(next);
+        }
+      }
+    }
+  }
+
+  uint64_t LogRouter::categoryRoutes(LogCategory const *category) const noexcept {
+    uint64_t res = m_any_category;
+    if (m_by_category.empty()) return res;
+
+    // Une regle sur une catégorie s'applique aussi a ses sous-catégories
+    std::string_view name = category ? std::string_view(category->name()) : std::string_view();
+
+    while (true) {
+      res |= findMask(m_by_category, name);
+      if (name.empty()) return res;
+
+      size_t pos = name.rfind('.');
+      name = pos == std::string_view::npos ? std::string_view() : name.substr(0, pos);
+    }
+  }
+
+  uint64_t LogRouter::codeRoutes(long code) const noexcept { return m_any_code | findMask(m_by_code, code); }
+
+  uint64_t LogRouter::messageRoutes(std::string_view message, uint64_t wanted) const noexcept {
+    uint64_t res = 0;
+    uint32_t state = 0;
+
+    for (char c : message) {
+      state = m_transitions[state * m_class_count + m_classes[uint8_t(c)]];
+      res |= m_outputs[state];
+
+      if ((res & wanted) == wanted) break;
+    }
+
+    return res;
+  }
+
+  uint64_t LogRouter::route(Log const &log, std::string_view message) const noexcept {
+    uint64_t routes = m_by_level[log.level()];
+    if (routes) routes &= categoryRoutes(log.category());
+    if (routes) routes &= codeRoutes(log.errorCode());
+
+    // L'automate n'est parcouru que si une regle encore candidate porte sur le message
+    uint64_t wanted = routes & ~m_any_message;
+    if (wanted) routes = (routes & m_any_message) | (wanted & messageRoutes(message, wanted));
+
+    uint64_t res = 0;
+    while (routes) {
+      res |= m_route_handlers[std::countr_zero(routes)];
+      routes &= routes - 1;
+    }
+
+    return res;
+  }
+
+}   // namespace tscl
@@ -0,0 +1,117 @@
+#include "LogStamp.hpp"
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace tscl {
+
+  namespace {
+    /**
+     * @brief Lettre identifiant chaque niveau dans render(), dans l'ordre de Log::log_level
+     *
+     */
+    constexpr std::string_view level_letters = "TDIWEF";
+
+    constexpr size_t level_count = level_letters.size();
+
+    /**
+     * @brief Identifiant du thread, 0 tant qu'il n'a pas été lu. Remis a zéro dans le fils apres un
+     * fork(), dont l'unique thread a un nouvel identifiant
+     *
+     */
+    constinit thread_local uint32_t tid = 0;
+
+    uint32_t threadId() noexcept {
+      if (tid) return tid;
+
+      static int const registered = pthread_atfork(nullptr, nullptr, []() { tid = 0; });
+      (void) registered;
+
+      tid = syscall(SYS_gettid);
+      return tid;
+    }
+  }   // namespace
+
+  LogStamp LogStamp::capture(uint8_t level) noexcept {
+    timespec ts{};
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    level = std::min<uint8_t>(level, level_count - 1);
+    return {0, uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec, threadId(), level};
+  }
+
+  void LogStamp::render(std::string &out) const {
+    if (not sequence) return;
+
+    char buffer[24];
+
+    out += '#';
+    out += level_letters[std::min<size_t>(level, level_count - 1)];
+    out.append(buffer, std::to_chars(std::begin(buffer), std::end(buffer), sequence).ptr);
+    out += " t";
+    out.append(buffer, std::to_chars(std::begin(buffer), std::end(buffer), thread).ptr);
+    out += ' ';
+  }
+
+  std::optional<LogStamp> LogStamp::parse(std::string_view line) noexcept {
+    if (line.size() < 3 or line[0] != '#') return std::nullopt;
+
+    size_t level = level_letters.find(line[1]);
+    if (level == std::string_view::npos) return std::nullopt;
+
+    char const *end = line.data() + line.size();
+
+    LogStamp res;
+    res.level = level;
+    auto [ptr, ec] = std::from_chars(line.data() + 2, end, res.sequence);
+    if (ec != std::errc() or end - ptr < 3 or ptr[0] != ' ' or ptr[1] != 't') return std::nullopt;
+
+    auto [tptr, tec] = std::from_chars(ptr + 2, end, res.thread);
+    if (tec != std::errc() or tptr == end or *tptr != ' ') return std::nullopt;
+
+    return res;
+  }
+
+  void SequenceChecker::add(uint64_t sequence) {
+    // Un second numéro 1 provient d'un nouveau gestionnaire écrivant a la suite du précédent
+    if (m_streams.empty() or (sequence == 1 and m_streams.back().has_first)) m_streams.emplace_back();
+
+    auto &stream = m_streams.back();
+    stream.has_first = stream.has_first or sequence == 1;
+    stream.sequences.push_back(sequence);
+    m_size++;
+  }
+
+  std::vector<SequenceChecker::Gap> SequenceChecker::gaps() {
+    std::vector<Gap> res;
+
+    for (auto &stream : m_streams) {
+      auto &sequences = stream.sequences;
+      std::sort(sequences.begin(), sequences.end());
+
+      for (size_t i = 1; i < sequences.size(); i++)
+        if (sequences[i] > sequences[i - 1] + 1)
+          res.push_back({sequences[i - 1] + 1, sequences[i] - 1});
+    }
+
+    return res;
+  }
+
+  size_t SequenceChecker::duplicates() {
+    size_t res = 0;
+
+    for (auto &stream : m_streams) {
+      auto &sequences = stream.sequences;
+      std::sort(sequences.begin(), sequences.end());
+
+      for (size_t i = 1; i < sequences.size(); i++)
+        if (sequences[i] == sequences[i - 1]) res++;
+    }
+
+    return res;
+  }
+
+}   // namespace tscl
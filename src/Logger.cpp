@@ -1,143 +1,421 @@
 
 #include "Logger.hpp"
-#include <unordered_map>
-
+#include "AsyncLogger.hpp"
+#include "LogIndex.hpp"
+#include "LogRouter.hpp"
+#include "LoggerConfig.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <typeinfo>
 
 namespace tscl {
 
-  std::string const &Log::levelToString(log_level level) {
-    static std::unordered_map<log_level, std::string> map = {
-            {Trace, "[Trace]"},     {Debug, "[Debug]"}, {Information, "[Information]"},
-            {Warning, "[Warning]"}, {Error, "[Error]"}, {Fatal, "[Fatal]"}};
+  namespace {
+    /**
+     * @brief Niveau a partir duquel les erreurs capturent leur pile, -1 si la capture est désactivée
+     *
+     */
+    constinit std::atomic<int> trace_level(-1);
+
+    /**
+     * @brief Recherche un nom dans une liste, sans tenir compte de la casse
+     *
+     * @param names Noms en minuscules
+     * @param name Nom recherché
+     * @return std::optional<size_t> Index du nom, ou std::nullopt s'il est absent
+     */
+    template<size_t N>
+    std::optional<size_t> findName(std::string_view const (&names)[N], std::string_view name) {
+      for (size_t i = 0; i < N; i++) {
+        if (names[i].size() != name.size()) continue;
+
+        bool equal = true;
+        for (size_t j = 0; j < name.size() and equal; j++) equal = std::tolower(name[j]) == names[i][j];
+
+        if (equal) return i;
+      }
+
+      return std::nullopt;
+    }
+  }   // namespace
+
+  std::optional<Log::log_level> Log::levelFromString(std::string_view name) {
+    static constexpr std::string_view names[] = {"trace", "debug", "information", "warning", "error", "fatal"};
+
+    auto res = findName(names, name);
+    if (not res) return std::nullopt;
+    return static_cast<log_level>(*res);
+  }
+
+  std::optional<BackendConfig::wait_t> BackendConfig::waitFromString(std::string_view name) {
+    static constexpr std::string_view names[] = {"spin", "yield", "park"};
 
-    return map[level];
+    auto res = findName(names, name);
+    if (not res) return std::nullopt;
+    return static_cast<wait_t>(*res);
   }
 
-  Log::Log(log_level level) : m_level(level) {}
+  Log::Log(log_level level)
+      : m_level(level), m_category(nullptr), m_context(&LogContext::current()) {}
+
+  Log::Log(log_level level, LogStamp const &stamp)
+      : m_level(level), m_category(nullptr), m_context(&LogContext::current()), m_stamp(stamp) {}
 
   void Log::level(log_level level) { m_level = level; }
 
   Log::log_level Log::level() const { return m_level; }
 
   std::string Log::prefix(timestamp_t ts_type) const {
-    std::stringstream tmp;
+    std::string res;
+    appendPrefix(res, ts_type);
+
+    return res;
+  }
+
+  void Log::appendPrefix(std::string &out, timestamp_t ts_type) const {
+    if (ts_type != timestamp_t::None) {
+      // Un log qui n'a pas été transmis par un Logger n'est pas daté
+      appendTimestamp(out, ts_type, m_stamp.time ? m_stamp.timePoint() : std::chrono::system_clock::now());
+      out += ' ';
+    }
+
+    if (not m_origin.empty()) {
+      out += m_origin;
+      return;
+    }
 
-    if (ts_type != timestamp_t::None) tmp << timestamp(ts_type) << " ";
+    out += levelToString(m_level);
 
-    tmp << levelToString(m_level);
+    if (m_category and not m_category->name().empty()) {
+      out += " [";
+      out += m_category->name();
+      out += ']';
+    }
 
-    return tmp.str();
+    if (m_context) m_context->render(out);
   }
 
   std::string Log::message() const { return messageImpl(); }
 
-  std::string StringLog::messageImpl() const { return " - " + m_str; }
+  void Log::appendMessage(std::string &out) const { out += message(); }
 
-  StringLog::StringLog(log_level level) : Log(level){};
+  std::string StringLog::messageImpl() const {
+    std::string res;
+    res += " - ";
+    res += m_str.view();
+    return res;
+  }
+
+  void StringLog::appendMessage(std::string &out) const {
+    // Une classe dérivée peut redéfinir message() ou messageImpl() : seul le type exact passe
+    // directement par le tampon
+    if (typeid(*this) != typeid(StringLog)) {
+      Log::appendMessage(out);
+      return;
+    }
+
+    out += " - ";
+    out += m_str.view();
+  }
 
-  StringLog::StringLog(std::string const &message, log_level level) : Log(level), m_str(message) {}
+  StringLog::StringLog(log_level level) : Log(level){};
 
-  StringLog::StringLog(std::string &&message, log_level level)
-      : Log(level), m_str(std::move(message)) {}
+  StringLog::StringLog(std::string_view message, log_level level) : Log(level), m_str(message) {}
 
-  StringLog::StringLog(StringLog &&other) : m_str(std::move(other.m_str)) {}
+  StringLog::StringLog(StringLog &&other) : Log(other), m_str(std::move(other.m_str)) {}
 
   StringLog &StringLog::operator=(StringLog &&other) {
+    Log::operator=(other);
     m_str = std::move(other.m_str);
     return *this;
   }
 
   std::string ErrorLog::messageImpl() const {
-    std::stringstream tmp;
-
-    tmp << " - " << m_str;
+    std::string res;
+    res += " - ";
+    res += m_str.view();
+    res += m_description.view();
 
-    if (m_description != "") {
-      tmp << m_description;
-    }
-
-    return tmp.str();
+    return res;
   }
 
-  ErrorLog::ErrorLog(std::string const &error, long code, log_level level,
-                     std::string const &description)
+  ErrorLog::ErrorLog(std::string_view error, long code, log_level level, std::string_view description)
       : StringLog(error, level), m_error_code(code) {
-    m_description = description;
-    size_t pos = 0;
+    // Seules les adresses sont capturées, les symboles sont résolus a l'affichage
+    int trace = trace_level.load(std::memory_order_relaxed);
+    if (trace >= 0 and level >= trace) m_trace = StackTrace::capture(1);
+
+    if (description.empty()) return;
 
-    if (m_description == "") return;
+    // Chaque ligne de la description est indentée, directement dans le tampon
+    m_description += indent;
 
-    while (pos != std::string::npos) {
-      pos = m_description.find('\n', pos);
-      if (pos == std::string::npos) break;
-      m_description.replace(pos, 1, "\n |\t");
-      pos += 1;
+    size_t pos;
+    while ((pos = description.find('\n')) != std::string_view::npos) {
+      m_description += description.substr(0, pos);
+      m_description += indent;
+      description.remove_prefix(pos + 1);
     }
-    m_description.insert(0, "\n |\t");
+
+    m_description += description;
+  }
+
+  void ErrorLog::traceLevel(std::optional<log_level> level) noexcept {
+    trace_level.store(level ? static_cast<int>(*level) : -1, std::memory_order_relaxed);
+  }
+
+  std::optional<Log::log_level> ErrorLog::traceLevel() noexcept {
+    int res = trace_level.load(std::memory_order_relaxed);
+    if (res < 0) return std::nullopt;
+    return static_cast<log_level>(res);
   }
 
   ErrorLog::ErrorLog(ErrorLog &&other) { *this = std::move(other); }
 
   ErrorLog &ErrorLog::operator=(ErrorLog &&other) {
-    m_str = std::move(other.m_str);
+    StringLog::operator=(std::move(other));
     m_error_code = other.m_error_code;
     m_description = std::move(other.m_description);
+    m_trace = other.m_trace;
     return *this;
   }
 
-  std::string ErrorLog::message() const {
-    std::stringstream tmp;
+  void ErrorLog::appendCode(std::string &out) const {
+    char code[16];
+    auto res = std::to_chars(code, code + sizeof(code), static_cast<unsigned>(static_cast<int>(m_error_code)), 16);
 
-    tmp << "[0x" << std::hex << (int) m_error_code << "]" << messageImpl();
-    return tmp.str();
+    out += "[0x";
+    out.append(code, res.ptr);
+    out += ']';
   }
 
-  LogHandler::LogHandler(bool enable, Log::log_level min_level)
-      : m_enabled(enable), m_min_level(min_level) {}
+  std::string ErrorLog::message() const {
+    std::string res;
+    appendCode(res);
+    res += messageImpl();
+    return res;
+  }
 
-  std::string StreamLogHandler::colorize(Log::log_level level) {
-    static std::unordered_map<Log::log_level, std::string> res = {
-            {Log::Trace, "\033[39;90m"},   {Log::Debug, "\033[39;36m"}, {Log::Information, "\033[39;34m"},
-            {Log::Warning, "\033[39;33m"}, {Log::Error, "\033[39;31m"}, {Log::Fatal, "\033[39;35m"}};
+  void ErrorLog::appendMessage(std::string &out) const {
+    // Comme pour StringLog, seuls les types fournis par la bibliotheque évitent messageImpl()
+    if (typeid(*this) != typeid(ErrorLog) and typeid(*this) != typeid(ExceptionLog)) {
+      Log::appendMessage(out);
+      return;
+    }
 
-    return res[level];
+    appendCode(out);
+    out += " - ";
+    out += m_str.view();
+    out += m_description.view();
   }
 
+  LogHandler::LogHandler(bool enable, Log::log_level min_level)
+      : m_enabled(enable), m_min_level(min_level), m_ts_type(timestamp_t::None), m_stamped(false),
+        m_sequence(0) {}
+
   StreamLogHandler::StreamLogHandler(std::ostream &out, bool use_ascii_color)
       : m_use_ascii_color(use_ascii_color) {
     m_out = &out;
     m_stream_owner = false;
   }
 
-  StreamLogHandler::StreamLogHandler(std::string const &path) : m_use_ascii_color(false) {
+  StreamLogHandler::StreamLogHandler(std::string const &path) : m_use_ascii_color(false), m_path(path) {
     m_out = new std::ofstream(path);
     m_stream_owner = true;
   }
 
+  StreamLogHandler::StreamLogHandler(std::string const &path, bool compress, size_t block_size)
+      : m_use_ascii_color(false), m_path(path) {
+    if (compress) {
+      m_compressor = std::make_unique<CompressedStreamBuf>(path, block_size);
+      m_out = new std::ostream(m_compressor.get());
+      if (not m_compressor->isOpen()) m_out->setstate(std::ios::badbit);
+    } else
+      m_out = new std::ofstream(path);
+
+    m_stream_owner = true;
+  }
+
   StreamLogHandler::~StreamLogHandler() {
     if (m_stream_owner) delete m_out;
   }
 
   void StreamLogHandler::log(Log const &log, std::string const &message) {
     std::unique_lock<std::shared_mutex> lock(m_main_mutex);
-    auto &out = *m_out;
+    if (not accepts(log.level())) return;
+
+    // La ligne est construite avant d'etre écrite, afin d'en connaitre la taille pour l'index
+    thread_local std::string line;
+    line.clear();
+
+    if (m_use_ascii_color) line += ansi_colors[log.level()];
+
+    appendHeader(line, log);
+    line += message;
+    line += '\n';
+
+    if (m_use_ascii_color) line += ansi_reset;
+
+    m_out->write(line.data(), line.size());
+    m_out->flush();
+
+    if (m_index) {
+      // Un log jamais capturé (envoyé directement au gestionnaire) est daté de son écriture
+      uint64_t time = log.stamp().time;
+      if (not time)
+        time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+
+      m_index->record(line.size(), log.level(), time);
+    }
+  }
+
+  bool StreamLogHandler::enableIndex(size_t max_records, std::chrono::milliseconds max_duration) {
+    std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+
+    // Les positions dans un fichier compressé ne correspondent pas a celles des logs
+    if (m_path.empty() or m_compressor) return false;
+
+    // Les logs déja écrits ne sont pas indexés, l'index commence a la fin actuelle du fichier
+    auto offset = m_out->tellp();
+    if (offset < 0) return false;
+
+    m_index = std::make_unique<LogIndexWriter>(m_path + ".idx", offset, max_records, max_duration);
+    return true;
+  }
+
+  void StreamLogHandler::flush() {
+    std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+    m_out->flush();
+
+    if (m_compressor) m_compressor->flush();
+    if (m_index) m_index->flush();
+  }
+
+  Logger::Logger() : m_root(*this, "", nullptr), m_backend(nullptr) {}
 
-    if (not enable() or log.level() < minLvl()) return;
-    if (m_use_ascii_color) out << colorize(log.level());
+  Logger::~Logger() { delete m_backend.exchange(nullptr); }
+
+  AsyncBackend &Logger::backend() {
+    AsyncBackend *res = m_backend.load(std::memory_order_acquire);
+    if (res) return *res;
+
+    std::lock_guard<std::mutex> lock(m_backend_mutex);
+    res = m_backend.load(std::memory_order_relaxed);
+
+    if (not res) {
+      res = new AsyncBackend(*this, m_backend_config);
+      m_backend.store(res, std::memory_order_release);
+    }
+
+    return *res;
+  }
 
-    out << log.prefix(tsType()) << log.message() << std::endl;
+  void Logger::backendConfig(BackendConfig const &config) {
+    std::lock_guard<std::mutex> lock(m_backend_mutex);
+    m_backend_config = config;
 
-    if (m_use_ascii_color) out << "\033[0m";
+    if (auto *async = m_backend.load(std::memory_order_relaxed)) async->configure(config);
+  }
+
+  BackendConfig Logger::backendConfig() {
+    std::lock_guard<std::mutex> lock(m_backend_mutex);
+    return m_backend_config;
+  }
+
+  void Logger::dispatch(Log const &log, std::string const &msg) noexcept {
+    std::shared_lock<ProfiledSharedMutex> lock(m_main_mutex);
+    deliver(log, msg);
+  }
+
+  void Logger::deliver(Log const &log, std::string const &msg) noexcept {
+    if (not m_router) {
+      for (auto &i : m_loggers) i.second->log(log, msg);
+      return;
+    }
+
+    for (auto *handler : m_unrouted) handler->log(log, msg);
+
+    for (uint64_t mask = m_router->route(log, msg); mask; mask &= mask - 1)
+      if (auto *handler = m_routed[std::countr_zero(mask)]) handler->log(log, msg);
+  }
+
+  void Logger::resolveRoutes() {
+    m_routed.clear();
+    m_unrouted.clear();
+    if (not m_router) return;
+
+    auto const &names = m_router->handlers();
+    m_routed.resize(names.size(), nullptr);
+
+    for (auto &[name, handler] : m_loggers) {
+      auto it = std::find(names.begin(), names.end(), name);
+      if (it == names.end()) m_unrouted.push_back(handler.get());
+      else
+        m_routed[it - names.begin()] = handler.get();
+    }
+  }
+
+  bool Logger::routes(std::vector<LogRoute> const &routes) {
+    auto router = LogRouter::compile(routes);
+
+    if (not router) {
+      operator()(ErrorLog("Cannot apply log routes : more than " + std::to_string(LogRouter::max_routes) + " routes",
+                          errors::ERR_INVALID_CONFIG, Log::Error));
+      return false;
+    }
+
+    std::unique_lock<ProfiledSharedMutex> lock(m_main_mutex);
+    m_router = std::make_unique<LogRouter>(std::move(*router));
+    resolveRoutes();
+    return true;
+  }
+
+  void Logger::clearRoutes() {
+    std::unique_lock<ProfiledSharedMutex> lock(m_main_mutex);
+    m_router.reset();
+    resolveRoutes();
   }
 
   Logger &Logger::operator()(Log const &log) noexcept {
-    std::shared_lock<std::shared_mutex> lock(m_main_mutex);
-    std::string msg = log.message();
+    std::shared_lock<ProfiledSharedMutex> lock(m_main_mutex);
+
+    // Le message n'est construit que si au moins un gestionnaire va l'afficher
+    bool accepted = false;
+    for (auto &i : m_loggers) {
+      if (i.second->accepts(log.level())) {
+        accepted = true;
+        break;
+      }
+    }
 
-    for (auto &i : m_loggers) i.second->log(log, msg);
+    if (accepted) {
+      log.capture();
+
+      // Le tampon est réutilisé d'un log a l'autre. Un gestionnaire peut lui meme envoyer un log,
+      // qui utilise alors son propre tampon
+      thread_local std::string buffer;
+      thread_local bool buffer_used = false;
+
+      std::string local;
+      std::string &msg = buffer_used ? local : buffer;
+      bool owner = not buffer_used;
+
+      buffer_used = true;
+      msg.clear();
+      log.appendMessage(msg);
+      if (auto *trace = log.stackTrace()) trace->render(msg, ErrorLog::indent);
+
+      deliver(log, msg);
+
+      if (owner) buffer_used = false;
+    }
 
     if (log.level() == Log::Fatal) {
       std::cout << "\n\nThe application has encountered a fatal error and must close.\n";
@@ -147,22 +425,127 @@ namespace tscl {
     return *this;
   }
 
-  Logger &Logger::operator()(std::string const &msg, Log::log_level level) noexcept {
+  Logger &Logger::operator()(std::string_view msg, Log::log_level level) noexcept {
     StringLog tmp(msg, level);
     operator()(tmp);
 
     return *this;
   }
 
+  LogOperation Logger::logAsync(Log const &log) {
+    AsyncBackend &async = backend();
+
+    // Un log Fatal arrete le programme : les logs en attente sont écrits avant lui
+    if (log.level() == Log::Fatal) {
+      flush();
+      operator()(log);
+    }
+
+    if (not accepts(log.level())) return LogOperation(&async, std::nullopt);
+
+    log.capture();
+    auto record = AsyncBackend::makeRecord(log);
+    if (async.tryPush(record)) return LogOperation(&async, std::nullopt);
+
+    // File pleine : le log sera mis de coté lors du co_await, ou a la destruction de l'opération
+    return LogOperation(&async, std::move(record));
+  }
+
+  LogOperation Logger::logAsync(std::string_view msg, Log::log_level level) {
+    return logAsync(StringLog(msg, level));
+  }
+
+  BackendOperation Logger::flushAsync() { return BackendOperation(&backend(), std::nullopt); }
+
+  BackendOperation Logger::removeHandlerAsync(std::string name) {
+    return BackendOperation(&backend(), std::move(name));
+  }
+
+  void Logger::resumeOn(std::function<void(std::coroutine_handle<>)> resumer) {
+    backend().resumer(std::move(resumer));
+  }
+
+  void Logger::flushHandlers() noexcept {
+    std::shared_lock<ProfiledSharedMutex> lock(m_main_mutex);
+
+    for (auto &i : m_loggers) i.second->flush();
+  }
+
+  void Logger::flush() noexcept {
+    AsyncBackend *async = m_backend.load(std::memory_order_acquire);
+
+    if (not async or async->onBackendThread()) {
+      flushHandlers();
+      return;
+    }
+
+    auto done = AsyncBackend::Completion::makeFlag();
+    if (not done) {
+      flushHandlers();
+      return;
+    }
+
+    async->flush({{}, {}, done});
+    done->wait(false, std::memory_order_acquire);
+  }
+
+  bool Logger::shutdown(std::chrono::milliseconds timeout) noexcept {
+    AsyncBackend *async = m_backend.load(std::memory_order_acquire);
+
+    if (not async or async->onBackendThread()) {
+      flushHandlers();
+      return true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    // Le drapeau est partagé avec le backend : si le délai expire, il l'écrira plus tard
+    auto done = AsyncBackend::Completion::makeFlag();
+    if (not done) return false;
+
+    async->flush({{}, {}, done});
+
+    while (not done->load(std::memory_order_acquire)) {
+      if (std::chrono::steady_clock::now() >= deadline) return false;
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    return true;
+  }
+
+  bool Logger::accepts(Log::log_level level) noexcept {
+    std::shared_lock<ProfiledSharedMutex> lock(m_main_mutex);
+
+    for (auto &i : m_loggers)
+      if (i.second->accepts(level)) return true;
+
+    return false;
+  }
+
   void Logger::removeHandler(std::string name) {
-    std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+    AsyncBackend *async = m_backend.load(std::memory_order_acquire);
+
+    if (not async or async->onBackendThread()) {
+      eraseHandler(name);
+      return;
+    }
+
+    // Le gestionnaire doit encore recevoir les logs asynchrones envoyés avant son retrait
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    async->removeHandler(std::move(name), {{}, {}, done});
+    done->wait(false, std::memory_order_acquire);
+  }
+
+  void Logger::eraseHandler(std::string const &name) {
+    std::unique_lock<ProfiledSharedMutex> lock(m_main_mutex);
 
     auto it = m_loggers.find(name);
 
     if (it != m_loggers.end()) {
       m_loggers.erase(it);
+      resolveRoutes();
       lock.unlock();
-      operator()("Removed log handler \"" + name + '\"');
+      operator()([&name]() { return "Removed log handler \"" + name + '\"'; });
       return;
     }
 
@@ -171,6 +554,96 @@ namespace tscl {
                      errors::ERR_UNKNOWN_HANDLER, Log::Warning));
   }
 
-  Logger &logger = Logger::singleton();
+  LogCategory::LogCategory(Logger &logger, std::string name, LogCategory *parent)
+      : m_logger(logger), m_name(std::move(name)), m_parent(parent),
+        m_effective_level(parent ? parent->level() : Log::Trace) {
+    if (not parent) m_level = Log::Trace;
+  }
+
+  void LogCategory::dispatch(Log &log) noexcept {
+    log.category(this);
+    m_logger(log);
+  }
+
+  void LogCategory::level(Log::log_level level) { m_logger.categoryLevel(*this, level); }
+
+  void LogCategory::resetLevel() { m_logger.categoryLevel(*this, std::nullopt); }
+
+  LogCategory &LogCategory::operator()(Log &&log) noexcept { return operator()(log); }
+
+  LogCategory &LogCategory::operator()(Log &log) noexcept {
+    if (enabled(log.level())) dispatch(log);
+    return *this;
+  }
+
+  LogCategory &LogCategory::operator()(std::string_view msg, Log::log_level level) noexcept {
+    if (not enabled(level)) return *this;
+
+    StringLog tmp(msg, level);
+    dispatch(tmp);
+    return *this;
+  }
+
+  LogCategory &Logger::findOrCreateCategory(std::string_view name) {
+    if (name.empty() or name == "root") return m_root;
+
+    auto it = m_categories.find(std::string(name));
+    if (it != m_categories.end()) return *it->second;
+
+    size_t pos = name.rfind('.');
+    LogCategory &parent = pos == std::string_view::npos ? m_root : findOrCreateCategory(name.substr(0, pos));
+
+    auto res = m_categories.emplace(name, std::unique_ptr<LogCategory>(new LogCategory(*this, std::string(name), &parent)));
+    return *res.first->second;
+  }
+
+  void Logger::updateCategories() {
+    auto resolve = [](LogCategory const &category) {
+      LogCategory const *current = &category;
+      // La racine possède toujours un niveau explicite
+      while (not current->m_level) current = current->m_parent;
+      return *current->m_level;
+    };
+
+    m_root.m_effective_level.store(resolve(m_root), std::memory_order_relaxed);
+    for (auto &i : m_categories) i.second->m_effective_level.store(resolve(*i.second), std::memory_order_relaxed);
+  }
+
+  void Logger::categoryLevel(LogCategory &category, std::optional<Log::log_level> level) {
+    std::unique_lock<std::mutex> lock(m_categories_mutex);
+
+    if (&category == &m_root and not level) level = Log::Trace;
+
+    category.m_level = level;
+    updateCategories();
+  }
+
+  LogCategory &Logger::category(std::string_view name) {
+    std::unique_lock<std::mutex> lock(m_categories_mutex);
+    return findOrCreateCategory(name);
+  }
+
+  void Logger::configure(LoggerConfig const &config) {
+    std::unique_lock<std::mutex> lock(m_categories_mutex);
+
+    for (auto &i : m_categories) i.second->m_level.reset();
+    m_root.m_level = config.root_level;
+
+    for (auto &[name, level] : config.categories) findOrCreateCategory(name).m_level = level;
+
+    updateCategories();
+    lock.unlock();
+
+    std::shared_lock<ProfiledSharedMutex> handlers_lock(m_main_mutex);
+
+    for (auto &[name, level] : config.handlers) {
+      auto it = m_loggers.find(name);
+      if (it != m_loggers.end()) it->second->minLvl(level);
+    }
+
+    handlers_lock.unlock();
+
+    if (config.backend) backendConfig(*config.backend);
+  }
 
 }   // namespace tscl
\ No newline at end of file
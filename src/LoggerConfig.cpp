@@ -0,0 +1,202 @@
+#include "LoggerConfig.hpp"
+#include <cctype>
+#include <charconv>
+#include <fstream>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace tscl {
+
+  namespace {
+    std::string_view trim(std::string_view str) {
+      while (not str.empty() and std::isspace(static_cast<unsigned char>(str.front()))) str.remove_prefix(1);
+      while (not str.empty() and std::isspace(static_cast<unsigned char>(str.back()))) str.remove_suffix(1);
+      return str;
+    }
+
+    template<typename T>
+    std::optional<T> parseNumber(std::string_view str) {
+      T res;
+      auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), res);
+      if (ec != std::errc() or ptr != str.data() + str.size()) return std::nullopt;
+      return res;
+    }
+  }   // namespace
+
+  LoggerConfig LoggerConfig::parse(std::istream &in, Logger &report) {
+    enum class section_t { Global, Categories, Handlers, Backend };
+
+    LoggerConfig res;
+    section_t section = section_t::Global;
+    std::string buffer;
+    size_t line_number = 0;
+
+    auto invalid = [&](std::string const &reason) {
+      report(ErrorLog("Invalid logger configuration at line " + std::to_string(line_number) + " : " + reason,
+                      errors::ERR_INVALID_CONFIG, Log::Warning));
+    };
+
+    while (std::getline(in, buffer)) {
+      line_number++;
+      std::string_view line = trim(std::string_view(buffer).substr(0, buffer.find('#')));
+
+      if (line.empty()) continue;
+
+      if (line.front() == '[') {
+        if (line == "[categories]") section = section_t::Categories;
+        else if (line == "[handlers]") section = section_t::Handlers;
+        else if (line == "[backend]") {
+          section = section_t::Backend;
+          if (not res.backend) res.backend.emplace();
+        }
+        else invalid("unknown section \"" + std::string(line) + "\"");
+        continue;
+      }
+
+      size_t pos = line.find('=');
+      if (pos == std::string_view::npos) {
+        invalid("expected \"name = level\"");
+        continue;
+      }
+
+      std::string_view name = trim(line.substr(0, pos));
+
+      if (section == section_t::Backend) {
+        std::string_view value = trim(line.substr(pos + 1));
+        auto &backend = *res.backend;
+        bool valid = true;
+
+        if (name == "wait") {
+          auto wait = BackendConfig::waitFromString(value);
+          if (wait) backend.wait = *wait;
+          valid = wait.has_value();
+        } else if (name == "spin") {
+          auto spin = parseNumber<uint32_t>(value);
+          if (spin) backend.spin = *spin;
+          valid = spin.has_value();
+        } else if (name == "yield") {
+          auto yield = parseNumber<uint32_t>(value);
+          if (yield) backend.yield = *yield;
+          valid = yield.has_value();
+        } else if (name == "cpu") {
+          auto cpu = parseNumber<int>(value);
+          if (cpu) backend.cpu = *cpu;
+          valid = cpu.has_value();
+        } else if (name == "name") {
+          backend.name = value;
+        } else if (name == "batch") {
+          auto batch = parseNumber<size_t>(value);
+          if (batch) backend.batch = *batch;
+          valid = batch.has_value() and *batch > 0;
+        } else if (name == "capacity") {
+          auto capacity = parseNumber<size_t>(value);
+          if (capacity) backend.capacity = *capacity;
+          valid = capacity.has_value() and *capacity > 0;
+        } else {
+          invalid("unknown backend option \"" + std::string(name) + "\"");
+          continue;
+        }
+
+        if (not valid) invalid("invalid value \"" + std::string(value) + "\" for \"" + std::string(name) + "\"");
+        continue;
+      }
+
+      auto level = Log::levelFromString(trim(line.substr(pos + 1)));
+
+      if (not level) {
+        invalid("unknown level \"" + std::string(trim(line.substr(pos + 1))) + "\"");
+        continue;
+      }
+
+      if (section == section_t::Handlers) res.handlers.emplace_back(name, *level);
+      else if (name == "root") res.root_level = *level;
+      else if (section == section_t::Categories) res.categories.emplace_back(name, *level);
+      else invalid("only \"root\" may be defined outside of a section");
+    }
+
+    return res;
+  }
+
+  std::optional<LoggerConfig> LoggerConfig::load(std::string const &path, Logger &report) {
+    std::ifstream file(path);
+
+    if (not file) {
+      report(ErrorLog("Cannot read logger configuration \"" + path + "\"", errors::ERR_UNREADABLE_CONFIG,
+                      Log::Warning));
+      return std::nullopt;
+    }
+
+    return parse(file, report);
+  }
+
+  ConfigWatcher::ConfigWatcher(Logger &logger, std::string path)
+      : m_logger(logger), m_path(std::move(path)), m_inotify_fd(-1), m_stop_fd(-1) {
+    reload();
+
+    // Le dossier est surveillé plutot que le fichier, la plupart des éditeurs remplaçant le fichier
+    size_t pos = m_path.rfind('/');
+    std::string directory = pos == std::string::npos ? "." : m_path.substr(0, pos + 1);
+
+    m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (m_inotify_fd < 0 or m_stop_fd < 0 or
+        inotify_add_watch(m_inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+      m_logger(ErrorLog("Cannot watch logger configuration \"" + m_path + "\"", errors::ERR_CONFIG_WATCH_FAILURE,
+                        Log::Warning));
+      return;
+    }
+
+    m_thread = std::thread(&ConfigWatcher::run, this);
+  }
+
+  ConfigWatcher::~ConfigWatcher() {
+    if (m_thread.joinable()) {
+      uint64_t value = 1;
+      [[maybe_unused]] auto res = write(m_stop_fd, &value, sizeof(value));
+      m_thread.join();
+    }
+
+    if (m_inotify_fd >= 0) close(m_inotify_fd);
+    if (m_stop_fd >= 0) close(m_stop_fd);
+  }
+
+  bool ConfigWatcher::reload() {
+    auto config = LoggerConfig::load(m_path, m_logger);
+    if (not config) return false;
+
+    m_logger.configure(*config);
+    return true;
+  }
+
+  void ConfigWatcher::run() {
+    size_t pos = m_path.rfind('/');
+    std::string filename = pos == std::string::npos ? m_path : m_path.substr(pos + 1);
+
+    alignas(inotify_event) char buffer[4096];
+    pollfd fds[2] = {{m_inotify_fd, POLLIN, 0}, {m_stop_fd, POLLIN, 0}};
+
+    while (true) {
+      if (poll(fds, 2, -1) < 0) continue;
+      if (fds[1].revents) return;
+
+      // Plusieurs évenements peuvent etre regroupés, le fichier n'est rechargé qu'une fois
+      bool modified = false;
+      ssize_t len;
+
+      while ((len = read(m_inotify_fd, buffer, sizeof(buffer))) > 0) {
+        for (char *ptr = buffer; ptr < buffer + len;) {
+          auto *event = reinterpret_cast<inotify_event *>(ptr);
+          if (event->len and filename == event->name) modified = true;
+          ptr += sizeof(inotify_event) + event->len;
+        }
+      }
+
+      if (modified) reload();
+    }
+  }
+
+}   // namespace tscl
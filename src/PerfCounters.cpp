@@ -0,0 +1,261 @@
+#include "PerfCounters.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <ctime>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace tscl {
+
+  namespace {
+    struct EventDesc {
+      uint32_t type;
+      uint64_t config;
+    };
+
+    constexpr EventDesc events[PerfCounters::counter_count] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK}};
+
+    constexpr uint32_t bit(PerfCounters::counter_t counter) noexcept { return 1u << counter; }
+
+    int openEvent(EventDesc const &event, int group) noexcept {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = event.type;
+      attr.config = event.config;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      attr.exclude_hv = 1;
+
+      int fd = syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+
+      // perf_event_paranoid >= 2 : seule la partie utilisateur peut etre mesurée
+      if (fd < 0 and (errno == EACCES or errno == EPERM)) {
+        attr.exclude_kernel = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+      }
+
+      return fd;
+    }
+
+    void appendNumber(std::string &out, uint64_t value) {
+      char buffer[24];
+      out.append(buffer, std::to_chars(std::begin(buffer), std::end(buffer), value).ptr);
+    }
+
+    void appendFixed(std::string &out, double value, int precision) {
+      char buffer[64];
+      out.append(buffer, std::to_chars(std::begin(buffer), std::end(buffer), value, std::chars_format::fixed, precision).ptr);
+    }
+  }   // namespace
+
+  std::string_view PerfCounters::counterName(counter_t counter) noexcept {
+    static constexpr std::string_view names[counter_count] = {"cycles",           "instructions", "cache-misses",
+                                                              "branch-misses",    "context-switches",
+                                                              "page-faults",      "cpu-time"};
+    return counter < counter_count ? names[counter] : "unknown";
+  }
+
+  PerfCounters::Sample &PerfCounters::Sample::operator+=(Sample const &other) noexcept {
+    wall += other.wall;
+    for (size_t i = 0; i < counter_count; i++) values[i] += other.values[i];
+    available |= other.available;
+    time_enabled += other.time_enabled;
+    time_running += other.time_running;
+    return *this;
+  }
+
+  PerfCounters::Sample PerfCounters::Sample::operator-(Sample const &other) const noexcept {
+    Sample res;
+    res.wall = wall - other.wall;
+    res.available = available & other.available;
+    res.time_enabled = time_enabled - other.time_enabled;
+    res.time_running = time_running - other.time_running;
+
+    for (size_t i = 0; i < counter_count; i++) res.values[i] = values[i] - other.values[i];
+
+    if (res.time_running and res.time_running < res.time_enabled) {
+      double scale = double(res.time_enabled) / res.time_running;
+      for (size_t i = Cycles; i <= BranchMisses; i++) res.values[i] = uint64_t(res.values[i] * scale);
+    }
+
+    return res;
+  }
+
+  void PerfCounters::Sample::format(std::string &out) const {
+    appendFixed(out, wall.count() * 1e3, 3);
+    out += "ms";
+
+    for (size_t i = 0; i < counter_count; i++) {
+      auto counter = counter_t(i);
+      if (not has(counter)) continue;
+
+      out += " | ";
+      out += counterName(counter);
+      out += ' ';
+
+      if (counter == CpuTime) {
+        appendFixed(out, values[i] / 1e6, 3);
+        out += "ms";
+      } else
+        appendNumber(out, values[i]);
+
+      if (counter == Instructions and has(Cycles) and values[Cycles]) {
+        out += " (";
+        appendFixed(out, double(values[Instructions]) / values[Cycles], 2);
+        out += " IPC)";
+      }
+    }
+
+    if (coverage() < 1) {
+      out += " | multiplexed ";
+      appendNumber(out, uint64_t(coverage() * 100));
+      out += '%';
+    }
+  }
+
+  PerfCounters::PerfCounters() : m_source(Fallback), m_paused(false) {
+    std::fill(std::begin(m_fds), std::end(m_fds), -1);
+    open();
+    m_start = snapshot();
+  }
+
+  PerfCounters::~PerfCounters() {
+    for (int fd : m_fds)
+      if (fd >= 0) close(fd);
+  }
+
+  bool PerfCounters::openGroup(Group &group, counter_t first, counter_t last) {
+    // Un compteur absent de la PMU n'empeche pas d'ouvrir les autres
+    for (size_t i = first; i <= last; i++) {
+      int fd = openEvent(events[i], group.leader);
+      if (fd < 0) continue;
+
+      if (group.leader < 0) group.leader = fd;
+      m_fds[i] = fd;
+      group.members[group.size++] = counter_t(i);
+    }
+
+    return group.leader >= 0;
+  }
+
+  void PerfCounters::open() {
+    bool hardware = openGroup(m_groups[0], Cycles, BranchMisses);
+    bool software = openGroup(m_groups[1], ContextSwitches, CpuTime);
+
+    m_source = hardware ? Hardware : software ? Software : Fallback;
+  }
+
+  PerfCounters &PerfCounters::thisThread() {
+    thread_local PerfCounters counters;
+    return counters;
+  }
+
+  PerfCounters::Sample PerfCounters::snapshot() const noexcept {
+    Sample res;
+    res.wall = std::chrono::high_resolution_clock::now() - program_start;
+
+    for (size_t g = 0; g < 2; g++) {
+      Group const &group = m_groups[g];
+      if (group.leader < 0) continue;
+
+      // Format PERF_FORMAT_GROUP : nombre de compteurs, temps activé, temps programmé, valeurs
+      uint64_t buffer[3 + counter_count];
+      if (read(group.leader, buffer, sizeof(buffer)) < ssize_t(3 * sizeof(uint64_t))) continue;
+
+      for (size_t i = 0; i < group.size and i < buffer[0]; i++) {
+        res.values[group.members[i]] = buffer[3 + i];
+        res.available |= bit(group.members[i]);
+      }
+
+      if (g == 0) {
+        res.time_enabled = buffer[1];
+        res.time_running = buffer[2];
+      }
+    }
+
+    // Compteurs logiciels sans perf_event_open
+    if (not res.has(ContextSwitches) or not res.has(PageFaults)) {
+      rusage usage{};
+      if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        res.values[ContextSwitches] = usage.ru_nvcsw + usage.ru_nivcsw;
+        res.values[PageFaults] = usage.ru_minflt + usage.ru_majflt;
+        res.available |= bit(ContextSwitches) | bit(PageFaults);
+      }
+    }
+
+    if (not res.has(CpuTime)) {
+      timespec ts{};
+      if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        res.values[CpuTime] = uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        res.available |= bit(CpuTime);
+      }
+    }
+
+    return res;
+  }
+
+  PerfCounters &PerfCounters::resume() noexcept {
+    if (m_paused) {
+      m_start = snapshot();
+      m_paused = false;
+    }
+
+    return *this;
+  }
+
+  PerfCounters &PerfCounters::pause() noexcept {
+    if (m_paused) return *this;
+
+    m_total += snapshot() - m_start;
+    m_paused = true;
+
+    return *this;
+  }
+
+  PerfCounters &PerfCounters::restart() noexcept {
+    m_paused = false;
+    m_total = Sample();
+    m_start = snapshot();
+
+    return *this;
+  }
+
+  PerfCounters::Sample PerfCounters::get() noexcept {
+    if (not m_paused) {
+      Sample current = snapshot();
+      m_total += current - m_start;
+      m_start = current;
+    }
+
+    return m_total;
+  }
+
+  PerfLog::PerfLog(std::string_view section, PerfCounters::Sample const &sample, Log::log_level level)
+      : Log(level), m_section(section), m_sample(sample) {}
+
+  std::string PerfLog::messageImpl() const {
+    std::string res = m_section;
+    res += " : ";
+    m_sample.format(res);
+    return res;
+  }
+
+  ScopedCounters::ScopedCounters(std::string_view section, Log::log_level level, Logger &logger)
+      : m_logger(logger), m_section(section), m_level(level), m_enabled(logger.accepts(level)) {
+    if (m_enabled) m_start = PerfCounters::thisThread().snapshot();
+  }
+
+  ScopedCounters::~ScopedCounters() {
+    if (m_enabled) m_logger(PerfLog(m_section, PerfCounters::thisThread().snapshot() - m_start, m_level));
+  }
+
+}   // namespace tscl
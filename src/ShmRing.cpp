@@ -0,0 +1,325 @@
+#include "ShmRing.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tscl {
+
+  namespace {
+    /**
+     * @brief Log reconstruit a partir d'un emplacement d'anneau
+     *
+     */
+    class ShmRecordLog : public Log {
+    private:
+      /**
+       * @brief Niveau d'origine, pid de l'écrivain et préfixe transmis, référencé par Log::origin()
+       *
+       */
+      std::string m_origin;
+      std::string_view m_message;
+      bool m_truncated;
+
+      virtual std::string messageImpl() const override {
+        std::string res(m_message);
+        if (m_truncated) res += " [...]";
+        return res;
+      }
+
+    public:
+      // Un log Fatal a déja arreté l'écrivain, il ne doit pas arreter le collecteur
+      ShmRecordLog(ShmRing::Slot &slot, std::string_view data)
+          : Log(std::min(static_cast<log_level>(slot.level), Log::Error), {0, slot.timestamp, slot.tid, slot.level}),
+            m_message(data.substr(slot.prefix_size)), m_truncated(slot.truncated) {
+        context(nullptr);
+
+        m_origin += levelToString(static_cast<log_level>(slot.level));
+        m_origin += " <";
+        m_origin += std::to_string(slot.pid);
+        m_origin += '>';
+        m_origin += data.substr(0, slot.prefix_size);
+        origin(m_origin);
+      }
+
+      ShmRecordLog(ShmRecordLog const &) = delete;
+      ShmRecordLog &operator=(ShmRecordLog const &) = delete;
+    };
+
+    /**
+     * @brief Pid du processus, 0 tant qu'il n'a pas été lu. Remis a zéro dans le fils apres un
+     * fork(), les workers pré-forkés devant signer leurs logs de leur propre pid
+     *
+     */
+    std::atomic<uint32_t> cached_pid{0};
+
+    uint32_t processId() noexcept {
+      uint32_t res = cached_pid.load(std::memory_order_relaxed);
+      if (res) return res;
+
+      static int const registered =
+              pthread_atfork(nullptr, nullptr, []() { cached_pid.store(0, std::memory_order_relaxed); });
+      (void) registered;
+
+      res = getpid();
+      cached_pid.store(res, std::memory_order_relaxed);
+      return res;
+    }
+
+    /**
+     * @brief Vrai si le log de l'emplacement a précédé celui de other. Les logs d'un meme anneau
+     * sont lus dans l'ordre de leur réservation, seuls ceux d'anneaux différents sont comparés
+     *
+     */
+    bool before(ShmRing::Slot const &slot, ShmRing::Slot const &other) noexcept {
+      return slot.timestamp < other.timestamp;
+    }
+  }   // namespace
+
+  ShmRing::ShmRing(std::string name, Header *header, size_t size)
+      : m_name(std::move(name)), m_header(header), m_size(size) {}
+
+  ShmRing::ShmRing(ShmRing &&other) noexcept
+      : m_name(std::move(other.m_name)), m_header(std::exchange(other.m_header, nullptr)), m_size(other.m_size) {}
+
+  ShmRing &ShmRing::operator=(ShmRing &&other) noexcept {
+    if (m_header) munmap(m_header, m_size);
+
+    m_name = std::move(other.m_name);
+    m_header = std::exchange(other.m_header, nullptr);
+    m_size = other.m_size;
+    return *this;
+  }
+
+  ShmRing::~ShmRing() {
+    if (m_header) munmap(m_header, m_size);
+  }
+
+  std::optional<ShmRing> ShmRing::create(std::string const &name, size_t slot_count, size_t slot_size) {
+    slot_count = std::bit_ceil(std::max<size_t>(slot_count, 2));
+    slot_size = (std::max(slot_size, sizeof(Slot) + 64) + 7) & ~size_t(7);
+
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0) return errno == EEXIST ? open(name) : std::nullopt;
+
+    size_t size = sizeof(Header) + slot_count * slot_size;
+    void *addr = MAP_FAILED;
+
+    if (ftruncate(fd, size) == 0) addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+      shm_unlink(name.c_str());
+      return std::nullopt;
+    }
+
+    // Le segment est rempli de zéros, seules les séquences doivent etre initialisées
+    auto *header = static_cast<Header *>(addr);
+    header->slot_size = slot_size;
+    header->slot_count = slot_count;
+
+    ShmRing res(name, header, size);
+    for (size_t i = 0; i < slot_count; i++) res.slot(i).sequence.store(i, std::memory_order_relaxed);
+
+    header->magic.store(magic, std::memory_order_release);
+    return res;
+  }
+
+  std::optional<ShmRing> ShmRing::open(std::string const &name) {
+    int fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) return std::nullopt;
+
+    // Le créateur peut encore etre en train d'initialiser le segment
+    struct stat st {};
+    for (int i = 0; i < 100 and fstat(fd, &st) == 0 and st.st_size < sizeof(Header); i++)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    void *addr = st.st_size < sizeof(Header)
+                         ? MAP_FAILED
+                         : mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) return std::nullopt;
+
+    auto *header = static_cast<Header *>(addr);
+    ShmRing res(name, header, st.st_size);
+
+    for (int i = 0; i < 100 and header->magic.load(std::memory_order_acquire) != magic; i++)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    if (header->magic.load(std::memory_order_acquire) != magic or
+        sizeof(Header) + size_t(header->slot_count) * header->slot_size > st.st_size)
+      return std::nullopt;
+
+    return res;
+  }
+
+  void ShmRing::unlink(std::string const &name) { shm_unlink(name.c_str()); }
+
+  ShmRing::Slot &ShmRing::slot(uint64_t index) noexcept {
+    auto *base = reinterpret_cast<char *>(m_header + 1);
+    return *reinterpret_cast<Slot *>(base + (index & (m_header->slot_count - 1)) * m_header->slot_size);
+  }
+
+  bool ShmRing::push(Log::log_level level, LogStamp const &stamp, std::string_view prefix,
+                     std::string_view message) noexcept {
+    uint64_t pos = m_header->write_index.load(std::memory_order_relaxed);
+    Slot *res;
+
+    while (true) {
+      res = &slot(pos);
+      uint64_t seq = res->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<int64_t>(seq - pos);
+
+      if (diff == 0) {
+        if (m_header->write_index.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = m_header->write_index.load(std::memory_order_relaxed);
+      }
+    }
+
+    uint32_t pid = processId();
+    res->owner.store((pos & 0xFFFFFFFF) << 32 | pid, std::memory_order_relaxed);
+
+    size_t prefix_size = std::min(prefix.size(), capacity());
+    size_t message_size = std::min(message.size(), capacity() - prefix_size);
+
+    res->timestamp = stamp.time;
+    res->pid = pid;
+    res->tid = stamp.thread;
+    res->level = level;
+    res->prefix_size = prefix_size;
+    res->message_size = message_size;
+    res->truncated = prefix_size + message_size < prefix.size() + message.size();
+    std::memcpy(res->data(), prefix.data(), prefix_size);
+    std::memcpy(res->data() + prefix_size, message.data(), message_size);
+
+    // Le collecteur a pu reprendre l'emplacement avant que le pid ne soit enregistré : le log est alors
+    // perdu (et déja compté par le collecteur), et la séquence de l'emplacement ne doit pas revenir en arriere
+    uint64_t expected = pos;
+    return res->sequence.compare_exchange_strong(expected, pos + 1, std::memory_order_release,
+                                                 std::memory_order_relaxed);
+  }
+
+  ShmRingLogHandler::ShmRingLogHandler(std::string const &name, size_t slot_count, size_t slot_size)
+      : m_ring([&]() {
+          auto res = ShmRing::create(name, slot_count, slot_size);
+          if (not res) throw std::runtime_error("Cannot open shared memory ring \"" + name + "\"");
+          return std::move(*res);
+        }()) {}
+
+  void ShmRingLogHandler::log(Log const &log, std::string const &message) {
+    if (not accepts(log.level())) return;
+
+    // Seule la partie du préfixe suivant le niveau est transmise, le collecteur ajoute le reste
+    thread_local std::string prefix;
+    prefix.clear();
+    log.appendPrefix(prefix, timestamp_t::None);
+
+    std::string_view tail = prefix;
+    tail.remove_prefix(std::min(tail.size(), Log::levelToString(log.level()).size()));
+
+    m_ring.push(log.level(), log.stamp(), tail, message);
+  }
+
+  ShmRingCollector::ShmRingCollector(Logger &logger) : m_logger(logger), m_lost(0) {}
+
+  bool ShmRingCollector::attach(std::string const &name) {
+    auto ring = ShmRing::open(name);
+    if (not ring) return false;
+
+    m_sources.push_back({std::move(*ring), {}, false});
+    return true;
+  }
+
+  ShmRing::Slot *ShmRingCollector::head(Source &source) {
+    auto &header = source.ring.header();
+
+    while (true) {
+      uint64_t pos = header.read_index.load(std::memory_order_relaxed);
+      auto &slot = source.ring.slot(pos);
+
+      if (slot.sequence.load(std::memory_order_acquire) == pos + 1) {
+        source.stalled = false;
+        return &slot;
+      }
+
+      if (header.write_index.load(std::memory_order_relaxed) == pos) return nullptr;
+
+      // Emplacement réservé mais pas encore publié : l'écrivain a pu s'arreter pendant l'écriture
+      auto current = std::chrono::steady_clock::now();
+      if (not source.stalled) {
+        source.stalled = true;
+        source.stalled_since = current;
+        return nullptr;
+      }
+
+      auto stalled = current - source.stalled_since;
+      if (stalled < stall_timeout) return nullptr;
+
+      // Un écrivain toujours en vie finira sa copie, qui écraserait le log suivant si l'emplacement
+      // était rendu aux écrivains. Seul un écrivain mort, ou jamais enregistré, est abandonné
+      uint64_t owner = slot.owner.load(std::memory_order_relaxed);
+      if (owner >> 32 == (pos & 0xFFFFFFFF) and (owner & 0xFFFFFFFF)) {
+        if (kill(static_cast<pid_t>(owner & 0xFFFFFFFF), 0) == 0 or errno != ESRCH) return nullptr;
+      } else if (stalled < orphan_timeout)
+        return nullptr;
+
+      // L'emplacement n'est repris que s'il n'a toujours pas été publié
+      uint64_t expected = pos;
+      if (not slot.sequence.compare_exchange_strong(expected, pos + header.slot_count, std::memory_order_acq_rel,
+                                                    std::memory_order_acquire))
+        continue;
+
+      header.read_index.store(pos + 1, std::memory_order_relaxed);
+      source.stalled = false;
+      m_lost++;
+    }
+  }
+
+  size_t ShmRingCollector::poll() {
+    std::string buffer;
+    size_t count = 0;
+
+    while (true) {
+      // Fusion chronologique : on transmet le plus ancien log disponible parmi tout les anneaux
+      Source *next = nullptr;
+      ShmRing::Slot *next_slot = nullptr;
+
+      for (auto &source : m_sources) {
+        ShmRing::Slot *slot = head(source);
+        if (slot and (not next_slot or before(*slot, *next_slot))) {
+          next = &source;
+          next_slot = slot;
+        }
+      }
+
+      if (not next) return count;
+
+      // Le log est copié avant de libérer l'emplacement pour les écrivains
+      buffer.assign(next_slot->data(), next_slot->prefix_size + next_slot->message_size);
+      ShmRecordLog log(*next_slot, buffer);
+
+      auto &header = next->ring.header();
+      uint64_t pos = header.read_index.load(std::memory_order_relaxed);
+      next_slot->sequence.store(pos + header.slot_count, std::memory_order_release);
+      header.read_index.store(pos + 1, std::memory_order_relaxed);
+
+      m_logger(log);
+      count++;
+    }
+  }
+
+}   // namespace tscl
@@ -0,0 +1,253 @@
+#include "SocketLogHandler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace tscl {
+
+  UnixSocketLogHandler::UnixSocketLogHandler(std::string path, socket_t type, size_t spool_capacity)
+      : m_path(std::move(path)), m_type(type), m_fd(-1), m_spool_size(0), m_spool_capacity(spool_capacity),
+        m_in_flight(0), m_dropped(0), m_connected(false), m_stop(false) {
+    connect();
+    m_thread = std::thread(&UnixSocketLogHandler::run, this);
+  }
+
+  UnixSocketLogHandler::~UnixSocketLogHandler() {
+    std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+    m_stop = true;
+    m_pending.notify_one();
+    lock.unlock();
+
+    m_thread.join();
+    disconnect();
+  }
+
+  void UnixSocketLogHandler::log(Log const &log, std::string const &message) {
+    if (not accepts(log.level())) return;
+
+    std::string record;
+    appendHeader(record, log);
+    record += message;
+    if (m_type == socket_t::Stream) record += '\n';
+
+    std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+    spool(std::move(record), false);
+    m_pending.notify_one();
+  }
+
+  void UnixSocketLogHandler::flush() {
+    std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+    m_sent.wait_for(lock, flush_timeout,
+                    [this]() { return (m_spool.empty() and m_partial.empty() and m_in_flight == 0) or not connected(); });
+  }
+
+  void UnixSocketLogHandler::spool(std::string &&record, bool front) {
+    if (m_spool_size + record.size() > m_spool_capacity) {
+      // Un log remis en tete de file est le plus ancien, c'est donc lui qui est abandonné
+      if (front) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+
+      while (not m_spool.empty() and m_spool_size + record.size() > m_spool_capacity) {
+        m_spool_size -= m_spool.front().size();
+        m_spool.pop_front();
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      if (record.size() > m_spool_capacity) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+
+    m_spool_size += record.size();
+    if (front) m_spool.push_front(std::move(record));
+    else
+      m_spool.push_back(std::move(record));
+  }
+
+  bool UnixSocketLogHandler::connect() {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+
+    if (m_path.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, m_path.c_str(), m_path.size() + 1);
+
+    m_fd = socket(AF_UNIX, (m_type == socket_t::Stream ? SOCK_STREAM : SOCK_DGRAM) | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (m_fd < 0) return false;
+
+    if (::connect(m_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      disconnect();
+      return false;
+    }
+
+    m_connected.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+  void UnixSocketLogHandler::disconnect() {
+    if (m_fd >= 0) close(m_fd);
+
+    m_fd = -1;
+    m_connected.store(false, std::memory_order_relaxed);
+  }
+
+  size_t UnixSocketLogHandler::send(std::string *batch, size_t count, bool &blocked, bool &partial) {
+    iovec iovs[max_batch];
+    blocked = false;
+    partial = false;
+
+    for (size_t i = 0; i < count; i++) iovs[i] = {batch[i].data(), batch[i].size()};
+
+    if (m_type == socket_t::Datagram) {
+      mmsghdr msgs[max_batch] = {};
+
+      for (size_t i = 0; i < count; i++) {
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      size_t done = 0;
+      while (done < count) {
+        int res = sendmmsg(m_fd, msgs + done, count - done, MSG_NOSIGNAL);
+
+        if (res >= 0) {
+          done += res;
+        } else if (errno == EMSGSIZE) {
+          // Un log trop grand pour un datagramme ne pourra jamais etre envoyé
+          m_dropped.fetch_add(1, std::memory_order_relaxed);
+          done++;
+        } else if (errno != EINTR) {
+          blocked = errno == EAGAIN;
+          return done;
+        }
+      }
+
+      return done;
+    }
+
+    size_t first = 0;
+    while (first < count) {
+      msghdr msg{};
+      msg.msg_iov = iovs + first;
+      msg.msg_iovlen = count - first;
+
+      ssize_t res = sendmsg(m_fd, &msg, MSG_NOSIGNAL);
+
+      if (res < 0) {
+        if (errno == EINTR) continue;
+
+        blocked = errno == EAGAIN;
+        partial = iovs[first].iov_base != batch[first].data();
+        batch[first].erase(0, static_cast<char *>(iovs[first].iov_base) - batch[first].data());
+        return first;
+      }
+
+      auto written = static_cast<size_t>(res);
+      while (written > 0) {
+        if (written >= iovs[first].iov_len) {
+          written -= iovs[first].iov_len;
+          first++;
+        } else {
+          iovs[first].iov_base = static_cast<char *>(iovs[first].iov_base) + written;
+          iovs[first].iov_len -= written;
+          written = 0;
+        }
+      }
+    }
+
+    return count;
+  }
+
+  void UnixSocketLogHandler::run() {
+    std::string batch[max_batch];
+    auto backoff = min_backoff;
+
+    std::unique_lock<std::shared_mutex> lock(m_main_mutex);
+
+    while (true) {
+      m_pending.wait(lock, [this]() { return m_stop or not m_spool.empty() or not m_partial.empty(); });
+      if (m_spool.empty() and m_partial.empty()) break;
+
+      if (m_fd < 0) {
+        lock.unlock();
+        bool res = connect();
+        lock.lock();
+
+        if (not res) {
+          if (m_stop) break;
+
+          m_sent.notify_all();
+          m_pending.wait_for(lock, backoff, [this]() { return m_stop; });
+          backoff = std::min(backoff * 2, max_backoff);
+          continue;
+        }
+
+        backoff = min_backoff;
+      }
+
+      size_t count = 0;
+      bool tail = not m_partial.empty();
+      if (tail) {
+        batch[count++] = std::move(m_partial);
+        m_partial.clear();
+      }
+
+      for (; count < max_batch and not m_spool.empty(); count++) {
+        batch[count] = std::move(m_spool.front());
+        m_spool_size -= batch[count].size();
+        m_spool.pop_front();
+      }
+
+      m_in_flight = count;
+      lock.unlock();
+
+      bool blocked, partial;
+      size_t sent = send(batch, count, blocked, partial);
+      partial = partial or (tail and sent == 0);
+
+      if (blocked) {
+        // Le collecteur ne lit pas assez vite, on attend qu'il libere de la place
+        pollfd fd = {m_fd, POLLOUT, 0};
+        poll(&fd, 1, static_cast<int>(min_backoff.count()) * 10);
+      }
+
+      lock.lock();
+      m_in_flight = 0;
+
+      if (sent < count) {
+        size_t first = sent;
+
+        // La fin d'un log entamé n'a de sens que sur la meme connexion : elle est gardée a part si
+        // la connexion reste valide, et abandonnée sinon pour ne pas corrompre la suivante
+        if (partial) {
+          if (blocked) m_partial = std::move(batch[first]);
+          else
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+          first++;
+        }
+
+        if (not blocked) disconnect();
+        for (size_t i = count; i-- > first;) spool(std::move(batch[i]), true);
+      }
+
+      m_sent.notify_all();
+
+      // Lors de l'arret, on n'attend pas indéfiniment un collecteur bloqué
+      if (blocked and m_stop) break;
+    }
+
+    // Les logs restants ne seront jamais envoyés
+    m_dropped.fetch_add(m_spool.size() + not m_partial.empty(), std::memory_order_relaxed);
+    m_spool.clear();
+    m_spool_size = 0;
+    m_partial.clear();
+  }
+
+}   // namespace tscl
@@ -0,0 +1,121 @@
+#include "StackTrace.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <unwind.h>
+
+namespace tscl {
+
+  namespace {
+    struct UnwindState {
+      void **frames;
+      size_t size;
+      size_t capacity;
+      size_t skip;
+    };
+
+    _Unwind_Reason_Code unwindCallback(_Unwind_Context *context, void *arg) {
+      auto &state = *static_cast<UnwindState *>(arg);
+      uintptr_t ip = _Unwind_GetIP(context);
+
+      if (not ip) return _URC_END_OF_STACK;
+
+      if (state.skip) {
+        state.skip--;
+        return _URC_NO_REASON;
+      }
+
+      state.frames[state.size++] = reinterpret_cast<void *>(ip);
+      return state.size == state.capacity ? _URC_END_OF_STACK : _URC_NO_REASON;
+    }
+
+    void appendHex(std::string &out, uintptr_t value) {
+      char buffer[2 * sizeof(uintptr_t)];
+      auto res = std::to_chars(buffer, buffer + sizeof(buffer), value, 16);
+
+      out += "0x";
+      out.append(buffer, res.ptr);
+    }
+
+    /**
+     * @brief Description d'une adresse, sans le numéro de niveau
+     *
+     */
+    std::string symbolize(void *address) {
+      std::string res;
+      auto ip = reinterpret_cast<uintptr_t>(address);
+
+      // Une adresse de retour pointe apres l'appel, qui peut etre la derniere instruction de la fonction
+      Dl_info info{};
+      if (not dladdr(reinterpret_cast<void *>(ip - 1), &info) or not info.dli_fname) {
+        appendHex(res, ip);
+        return res;
+      }
+
+      if (info.dli_sname) {
+        int status = 0;
+        std::unique_ptr<char, decltype(&std::free)> demangled(
+                abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), &std::free);
+
+        res += status == 0 ? demangled.get() : info.dli_sname;
+        res += '+';
+        appendHex(res, ip - reinterpret_cast<uintptr_t>(info.dli_saddr));
+        res += " (";
+        res += info.dli_fname;
+        res += ')';
+      } else {
+        res += info.dli_fname;
+        res += '+';
+        appendHex(res, ip - reinterpret_cast<uintptr_t>(info.dli_fbase));
+      }
+
+      return res;
+    }
+
+    /**
+     * @brief Symboles déja résolus, par adresse. N'est jamais détruit, le Logger statique pouvant
+     * encore afficher des piles pendant la destruction des variables statiques
+     *
+     */
+    struct SymbolCache {
+      std::mutex mutex;
+      std::unordered_map<void *, std::string> symbols;
+    };
+
+    SymbolCache &symbolCache() {
+      static SymbolCache *res = new SymbolCache;
+      return *res;
+    }
+  }   // namespace
+
+  StackTrace StackTrace::capture(size_t skip) noexcept {
+    StackTrace res;
+    UnwindState state{res.m_frames, 0, max_frames, skip + 1};
+
+    _Unwind_Backtrace(unwindCallback, &state);
+    res.m_size = state.size;
+    return res;
+  }
+
+  void StackTrace::render(std::string &out, std::string_view prefix) const {
+    auto &cache = symbolCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    for (size_t i = 0; i < m_size; i++) {
+      auto it = cache.symbols.find(m_frames[i]);
+      if (it == cache.symbols.end()) it = cache.symbols.emplace(m_frames[i], symbolize(m_frames[i])).first;
+
+      out += prefix;
+      out += '#';
+      out += std::to_string(i);
+      out += ' ';
+      out += it->second;
+    }
+  }
+
+}   // namespace tscl
@@ -3,34 +3,48 @@
 //
 
 #include "Time.hpp"
+#include <charconv>
+#include <ctime>
 
 namespace tscl {
 
   using namespace std::chrono;
 
+  [[gnu::init_priority(101)]] high_resolution_clock::time_point const program_start = high_resolution_clock::now();
+
   std::string timestamp(timestamp_t tst) {
-    std::stringstream ss;
+    std::string res;
+    appendTimestamp(res, tst, system_clock::now());
+    return res;
+  }
 
+  void appendTimestamp(std::string &out, timestamp_t tst, system_clock::time_point time) {
+    char buffer[64];
 
-    if (tst == timestamp_t::None) return "";
+    if (tst == timestamp_t::None) return;
     else if (tst == timestamp_t::Delta) {
-      high_resolution_clock::time_point current = high_resolution_clock::now();
-      std::chrono::duration<double> tmp = current - program_start;
+      // La date peut venir d'une autre horloge que program_start : l'écart est mesuré depuis maintenant
+      duration<double> tmp = (high_resolution_clock::now() - program_start) - (system_clock::now() - time);
+
+      out.append(buffer, std::to_chars(std::begin(buffer), std::end(buffer), tmp.count(), std::chars_format::fixed, 5).ptr);
+      out += 's';
+      return;
+    }
 
-      ss << std::fixed << std::setprecision(5) << tmp.count() << 's';
-    } else if (tst == timestamp_t::Partial) {
-      auto t = std::time(nullptr);
-      auto tm = *std::localtime(&t);
+    std::time_t t = system_clock::to_time_t(time);
+    std::tm tm{};
+    localtime_r(&t, &tm);
 
-      ss << std::put_time(&tm, "%H:%M:%S");
-    } else if (tst == timestamp_t::Full) {
-      auto t = std::time(nullptr);
-      auto tm = *std::localtime(&t);
+    out.append(buffer, std::strftime(buffer, sizeof(buffer), tst == timestamp_t::Partial ? "%H:%M:%S" : "%d-%m-%Y %H:%M:%S", &tm));
 
-      ss << std::put_time(&tm, "%d-%m-%Y %H:%M:%S");
-    }
+    if (tst == timestamp_t::Precise) {
+      auto nanoseconds = duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count() % 1000000000;
+      auto res = std::to_chars(buffer + 1, std::end(buffer), 1000000000 + nanoseconds);
 
-    return ss.str();
+      // Le 1 en tete assure l'affichage des zéros de gauche
+      buffer[1] = '.';
+      out.append(buffer + 1, res.ptr);
+    }
   }
 
   Chrono::Chrono() : m_current_duration(0), m_paused(false) {
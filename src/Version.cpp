@@ -1,4 +1,6 @@
-#include <sstream>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
 #include <Version.hpp>
 
 namespace tscl {
@@ -15,27 +17,154 @@ namespace tscl {
 
   }
 
-  bool Version::operator>(const Version &other) const {
-    return (major_ver > other.major_ver) or (major_ver == other.major_ver and minor_ver > other.minor_ver) or
-           (major_ver == other.major_ver and minor_ver == other.minor_ver and patch_ver > other.patch_ver and
-            (tweak.empty() or tweak > other.tweak));
+  std::strong_ordering Version::operator<=>(const Version &other) const {
+    if (auto cmp = major_ver <=> other.major_ver; cmp != 0) return cmp;
+    if (auto cmp = minor_ver <=> other.minor_ver; cmp != 0) return cmp;
+    if (auto cmp = patch_ver <=> other.patch_ver; cmp != 0) return cmp;
+    return compareTweak(tweak, other.tweak);
   }
 
-  bool Version::operator<(const tscl::Version &other) const {
-    return not(*this == other) and not(*this > other);
+  Version::Version(std::string_view version) {
+    auto parts = parse(version);
+    if (not parts) throw std::invalid_argument("Invalid version \"" + std::string(version) + "\"");
+
+    major_ver = parts->major;
+    minor_ver = parts->minor;
+    patch_ver = parts->patch;
+    tweak = parts->tweak;
+  }
+
+  std::ostream &operator<<(std::ostream &os, const Version &version) { return os << version.to_string(); }
+
+  namespace {
+    /**
+     * @brief Compare deux versions de meme clé, les autres étant déja ordonnées par leurs clés
+     *
+     */
+    bool keyLess(uint64_t lhs_key, Version const &lhs, uint64_t rhs_key, Version const &rhs) {
+      return lhs_key < rhs_key or (lhs_key == rhs_key and lhs < rhs);
+    }
+  }   // namespace
+
+  std::optional<VersionRange> VersionRange::parse(std::string_view constraint) {
+    VersionRange res;
+
+    // Ne remplace une borne que si la nouvelle est plus restrictive
+    auto restrictLower = [&](Version const &version, bool inclusive) {
+      if (not res.lower or version > res.lower->version or
+          (version == res.lower->version and not inclusive))
+        res.lower = Bound{version, inclusive};
+    };
+    auto restrictUpper = [&](Version const &version, bool inclusive) {
+      if (not res.upper or version < res.upper->version or
+          (version == res.upper->version and not inclusive))
+        res.upper = Bound{version, inclusive};
+    };
+
+    while (true) {
+      size_t begin = constraint.find_first_not_of(' ');
+      if (begin == std::string_view::npos) break;
+      constraint.remove_prefix(begin);
+
+      std::string_view term = constraint.substr(0, constraint.find(' '));
+      constraint.remove_prefix(term.size());
+
+      size_t op_size = term.find_first_not_of("<>=");
+      if (op_size == std::string_view::npos) return std::nullopt;
+
+      std::string_view op = term.substr(0, op_size);
+      auto parts = Version::parse(term.substr(op_size));
+      if (not parts) return std::nullopt;
+
+      Version version(parts->major, parts->minor, parts->patch, std::string(parts->tweak));
+
+      if (op == ">=") restrictLower(version, true);
+      else if (op == ">")
+        restrictLower(version, false);
+      else if (op == "<=")
+        restrictUpper(version, true);
+      else if (op == "<")
+        restrictUpper(version, false);
+      else if (op == "=" or op == "==" or op.empty()) {
+        restrictLower(version, true);
+        restrictUpper(version, true);
+      } else
+        return std::nullopt;
+    }
+
+    return res;
   }
 
-  Version::Version(std::string const &version) {
-    std::stringstream ss(version);
-    if (version.starts_with("v")) { ss.ignore(1); }
+  bool VersionRange::aboveLower(Version const &version) const noexcept {
+    if (not lower) return true;
+
+    auto cmp = version <=> lower->version;
+    return cmp > 0 or (cmp == 0 and lower->inclusive);
+  }
+
+  bool VersionRange::belowUpper(Version const &version) const noexcept {
+    if (not upper) return true;
+
+    auto cmp = version <=> upper->version;
+    return cmp < 0 or (cmp == 0 and upper->inclusive);
+  }
+
+  bool VersionRange::empty() const noexcept {
+    if (not lower or not upper) return false;
+
+    auto cmp = lower->version <=> upper->version;
+    return cmp > 0 or (cmp == 0 and not(lower->inclusive and upper->inclusive));
+  }
+
+  VersionSet::VersionSet(std::vector<Version> versions) {
+    std::vector<uint64_t> keys(versions.size());
+    std::vector<size_t> order(versions.size());
+
+    for (size_t i = 0; i < versions.size(); i++) keys[i] = versions[i].key();
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+      return keyLess(keys[lhs], versions[lhs], keys[rhs], versions[rhs]);
+    });
+
+    m_versions.reserve(versions.size());
+    m_keys.reserve(versions.size());
+
+    for (size_t i : order) {
+      m_versions.push_back(std::move(versions[i]));
+      m_keys.push_back(keys[i]);
+    }
+  }
+
+  void VersionSet::insert(Version version) {
+    uint64_t key = version.key();
+    auto [first, last] = std::equal_range(m_keys.begin(), m_keys.end(), key);
+
+    // Parmi les versions de meme clé, la position est donnée par operator<=>
+    auto pos = std::upper_bound(m_versions.begin() + (first - m_keys.begin()),
+                                m_versions.begin() + (last - m_keys.begin()), version) -
+               m_versions.begin();
+
+    m_keys.insert(m_keys.begin() + pos, key);
+    m_versions.insert(m_versions.begin() + pos, std::move(version));
+  }
+
+  std::span<Version const> VersionSet::satisfying(VersionRange const &range) const {
+    if (range.empty()) return {};
+
+    uint64_t lower_key = range.lowerKey(), upper_key = range.upperKey();
+    size_t begin = std::lower_bound(m_keys.begin(), m_keys.end(), lower_key) - m_keys.begin();
+    size_t end = std::upper_bound(m_keys.begin() + begin, m_keys.end(), upper_key) - m_keys.begin();
+
+    // Seules les versions partageant la clé d'une borne restent a comparer a la borne elle meme
+    while (begin < end and m_keys[begin] == lower_key and not range.aboveLower(m_versions[begin])) begin++;
+    while (end > begin and m_keys[end - 1] == upper_key and not range.belowUpper(m_versions[end - 1])) end--;
+
+    return std::span<Version const>(m_versions.data() + begin, end - begin);
+  }
 
-    ss >> major_ver;
-    ss.ignore(1);
-    ss >> minor_ver;
-    ss.ignore(1);
-    ss >> patch_ver;
-    ss.ignore(1);
-    std::getline(ss, tweak);
+  Version const *VersionSet::maxSatisfying(VersionRange const &range) const {
+    auto res = satisfying(range);
+    return res.empty() ? nullptr : &res.back();
   }
 
-}   // namespace tscl
\ No newline at end of file
+}   // namespace tscl
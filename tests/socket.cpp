@@ -0,0 +1,238 @@
+/** Teste UnixSocketLogHandler contre un collecteur local minimal : livraison des datagrammes, tampon
+ * pendant l'absence du collecteur, découpage des logs d'un flux bloqué et perte de la connexion
+ */
+
+#include <tscl.hpp>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace tscl;
+
+namespace {
+  using socket_t = UnixSocketLogHandler::socket_t;
+
+  constexpr size_t payload_size = 1000;
+
+  int failures = 0;
+
+  void check(bool condition, std::string const &what) {
+    if (condition) return;
+
+    std::cerr << "FAIL: " << what << "\n";
+    failures++;
+  }
+
+  int listenOn(std::string const &path, int type) {
+    unlink(path.c_str());
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, type | SOCK_CLOEXEC, 0);
+    if (fd < 0 or bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) return -1;
+    if (type == SOCK_STREAM and listen(fd, 4) < 0) return -1;
+
+    return fd;
+  }
+
+  int acceptWithin(int fd, int timeout_ms) {
+    pollfd pfd = {fd, POLLIN, 0};
+    if (poll(&pfd, 1, timeout_ms) <= 0) return -1;
+
+    return accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+  }
+
+  /**
+   * @brief Lit tout ce qui arrive sur le socket, jusqu'a ce qu'il reste silencieux quiet_ms
+   *
+   */
+  std::string drain(int fd, int quiet_ms) {
+    std::string res;
+    char buffer[65536];
+
+    pollfd pfd = {fd, POLLIN, 0};
+    while (poll(&pfd, 1, quiet_ms) > 0) {
+      ssize_t size = recv(fd, buffer, sizeof(buffer), 0);
+      if (size <= 0) break;
+      res.append(buffer, size);
+    }
+
+    return res;
+  }
+
+  std::string record(size_t index) { return "record " + std::to_string(index) + " " + std::string(payload_size, 'x'); }
+
+  /**
+   * @brief Découpe un flux en lignes, et vérifie que chacune est un log complet
+   *
+   * @return std::vector<size_t> Les index des logs recus, dans l'ordre
+   */
+  std::vector<size_t> parseStream(std::string const &stream, std::string const &what) {
+    std::vector<size_t> res;
+
+    size_t begin = 0, end;
+    while ((end = stream.find('\n', begin)) != std::string::npos) {
+      std::string_view line(stream.data() + begin, end - begin);
+      begin = end + 1;
+
+      // Trace émise par addHandler
+      if (line.starts_with("[Trace]")) continue;
+
+      size_t pos = line.find("record ");
+      bool complete = line.starts_with('[') and pos != std::string_view::npos and line.size() > payload_size and
+                      line.find_first_not_of('x', line.size() - payload_size) == std::string_view::npos;
+
+      check(complete, what + ": line \"" + std::string(line.substr(0, 60)) + "...\" is not a complete record");
+      if (complete) res.push_back(std::stoul(std::string(line.substr(pos + 7))));
+    }
+
+    return res;
+  }
+
+  void datagramDelivery(std::string const &path) {
+    int collector = listenOn(path, SOCK_DGRAM);
+    check(collector >= 0, "datagram: cannot bind " + path);
+
+    Logger log;
+    auto &handler = log.addHandler<UnixSocketLogHandler>("socket", path, socket_t::Datagram);
+    check(handler.connected(), "datagram: handler not connected");
+
+    size_t received = 0;
+    std::thread reader([&]() {
+      char buffer[4096];
+      pollfd pfd = {collector, POLLIN, 0};
+      while (poll(&pfd, 1, 300) > 0) {
+        ssize_t size = recv(collector, buffer, sizeof(buffer), 0);
+        if (size <= 0) break;
+        if (std::string_view(buffer, size).find("record ") != std::string_view::npos) received++;
+      }
+    });
+
+    for (size_t i = 0; i < 200; i++) log(record(i), Log::Information);
+    log.flush();
+    reader.join();
+
+    check(received == 200, "datagram: received " + std::to_string(received) + " of 200");
+    check(handler.dropped() == 0, "datagram: dropped " + std::to_string(handler.dropped()));
+    close(collector);
+  }
+
+  void spoolUntilConnected(std::string const &path) {
+    unlink(path.c_str());
+
+    Logger log;
+    auto &handler = log.addHandler<UnixSocketLogHandler>("socket", path, socket_t::Stream);
+    check(not handler.connected(), "spool: handler connected without a collector");
+
+    for (size_t i = 0; i < 100; i++) log(record(i), Log::Information);
+
+    int collector = listenOn(path, SOCK_STREAM);
+    int connection = acceptWithin(collector, 5000);
+    check(connection >= 0, "spool: handler did not reconnect");
+
+    log.flush();
+    auto indexes = parseStream(drain(connection, 300), "spool");
+
+    check(indexes.size() == 100, "spool: received " + std::to_string(indexes.size()) + " of 100");
+    check(std::is_sorted(indexes.begin(), indexes.end()), "spool: records out of order");
+    check(handler.dropped() == 0, "spool: dropped " + std::to_string(handler.dropped()));
+
+    close(connection);
+    close(collector);
+  }
+
+  void blockedStream(std::string const &path) {
+    int collector = listenOn(path, SOCK_STREAM);
+
+    Logger log;
+    // Un tampon plus petit que les logs envoyés force l'abandon des plus anciens
+    auto &handler = log.addHandler<UnixSocketLogHandler>("socket", path, socket_t::Stream, 64 * 1024);
+    int connection = acceptWithin(collector, 1000);
+    check(connection >= 0, "blocked: no connection");
+
+    // La trace d'addHandler est envoyée avant de remplir le tampon, pour ne compter que les logs du test
+    log.flush();
+
+    int size = 4096;
+    setsockopt(connection, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+    constexpr size_t total = 2000;
+    for (size_t i = 0; i < total; i++) log(record(i), Log::Information);
+
+    // Le handler est bloqué au milieu d'un log tant que le collecteur ne lit pas
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::string stream;
+    std::thread reader([&]() { stream = drain(connection, 500); });
+    log.flush();
+    reader.join();
+
+    auto indexes = parseStream(stream, "blocked");
+    check(std::is_sorted(indexes.begin(), indexes.end()), "blocked: records out of order");
+    check(indexes.size() + handler.dropped() == total,
+          "blocked: received " + std::to_string(indexes.size()) + " and dropped " +
+                  std::to_string(handler.dropped()) + " of " + std::to_string(total));
+
+    close(connection);
+    close(collector);
+  }
+
+  void lostConnection(std::string const &path) {
+    int collector = listenOn(path, SOCK_STREAM);
+
+    Logger log;
+    auto &handler = log.addHandler<UnixSocketLogHandler>("socket", path, socket_t::Stream);
+    int first = acceptWithin(collector, 1000);
+    check(first >= 0, "lost: no connection");
+
+    int size = 4096;
+    setsockopt(first, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+    for (size_t i = 0; i < 500; i++) log(record(i), Log::Information);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Le collecteur disparait alors que le handler est au milieu d'un log
+    close(first);
+
+    int second = acceptWithin(collector, 5000);
+    check(second >= 0, "lost: handler did not reconnect");
+
+    std::string stream;
+    std::thread reader([&]() { stream = drain(second, 500); });
+    log.flush();
+    reader.join();
+
+    // La connexion suivante ne doit commencer par aucune fin de log
+    auto indexes = parseStream(stream, "lost");
+    check(not indexes.empty(), "lost: nothing received after reconnecting");
+    check(std::is_sorted(indexes.begin(), indexes.end()), "lost: records out of order");
+    check(handler.dropped() <= 1, "lost: dropped " + std::to_string(handler.dropped()));
+
+    close(second);
+    close(collector);
+  }
+}   // namespace
+
+int main() {
+  char dir[] = "/tmp/tscl-socket-XXXXXX";
+  if (not mkdtemp(dir)) return 1;
+
+  std::string base = dir;
+  datagramDelivery(base + "/dgram.sock");
+  spoolUntilConnected(base + "/spool.sock");
+  blockedStream(base + "/blocked.sock");
+  lostConnection(base + "/lost.sock");
+
+  for (auto name : {"/dgram.sock", "/spool.sock", "/blocked.sock", "/lost.sock"}) unlink((base + name).c_str());
+  rmdir(dir);
+
+  if (failures) return 1;
+
+  std::cout << "All socket handler tests passed\n";
+  return 0;
+}
@@ -0,0 +1,70 @@
+/** tscl-collector : vide un ou plusieurs anneaux de logs en mémoire partagée vers la sortie standard
+ * ou vers un fichier
+ *
+ * Usage : tscl-collector [-o fichier] [-u] /anneau...
+ *   -o fichier  Ecrit les logs dans un fichier plutot que sur la sortie standard
+ *   -u          Supprime les segments a l'arret du collecteur
+ */
+
+#include <tscl.hpp>
+#include <csignal>
+#include <cstring>
+
+namespace {
+  volatile std::sig_atomic_t stop_requested = 0;
+
+  void requestStop(int) { stop_requested = 1; }
+}   // namespace
+
+int main(int argc, char **argv) {
+  std::string output;
+  bool unlink_rings = false;
+  std::vector<std::string> pending;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "-o") == 0 and i + 1 < argc) output = argv[++i];
+    else if (std::strcmp(argv[i], "-u") == 0)
+      unlink_rings = true;
+    else
+      pending.emplace_back(argv[i]);
+  }
+
+  if (pending.empty()) {
+    std::cerr << "Usage : " << argv[0] << " [-o file] [-u] /ring...\n";
+    return 1;
+  }
+
+  std::signal(SIGINT, requestStop);
+  std::signal(SIGTERM, requestStop);
+
+  if (output.empty()) tscl::logger().addHandler<tscl::StreamLogHandler>("output", std::cout);
+  else
+    tscl::logger().addHandler<tscl::StreamLogHandler>("output", output);
+
+  tscl::ShmRingCollector collector;
+  std::vector<std::string> rings;
+  auto last_attach = std::chrono::steady_clock::time_point();
+
+  while (not stop_requested) {
+    // Les anneaux pas encore créés par les workers sont recherchés régulierement
+    auto current = std::chrono::steady_clock::now();
+    if (not pending.empty() and current - last_attach > std::chrono::seconds(1)) {
+      last_attach = current;
+      std::erase_if(pending, [&](std::string const &name) {
+        if (not collector.attach(name)) return false;
+        rings.push_back(name);
+        return true;
+      });
+    }
+
+    if (collector.poll() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  collector.poll();
+  tscl::logger().flush();
+
+  if (unlink_rings)
+    for (auto &name : rings) tscl::ShmRing::unlink(name);
+
+  return 0;
+}
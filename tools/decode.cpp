@@ -0,0 +1,87 @@
+/** tscl-decode : décompresse un fichier de logs écrit par un StreamLogHandler compressé
+ *
+ * Usage : tscl-decode [-o fichier] [-g] fichier.lz4
+ *   -o fichier  Ecrit les logs dans un fichier plutot que sur la sortie standard
+ *   -g          Vérifie les numéros de séquence des lignes (handler.stamped(true)), et affiche
+ *               les logs manquants sur la sortie d'erreur
+ *
+ * Un fichier tronqué (programme arreté pendant l'écriture) est décompressé jusqu'au dernier bloc
+ * complet. Le code de retour vaut alors 2, et 1 si le fichier est invalide ou corrompu
+ */
+
+#include <tscl.hpp>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+int main(int argc, char **argv) {
+  std::string output;
+  std::string input;
+  bool check_gaps = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "-o") == 0 and i + 1 < argc) output = argv[++i];
+    else if (std::strcmp(argv[i], "-g") == 0) check_gaps = true;
+    else
+      input = argv[i];
+  }
+
+  if (input.empty()) {
+    std::cerr << "Usage : " << argv[0] << " [-o file] [-g] file\n";
+    return 1;
+  }
+
+  std::ifstream in(input, std::ios::binary);
+  if (not in) {
+    std::cerr << "Cannot open \"" << input << "\"\n";
+    return 1;
+  }
+
+  std::ofstream file;
+  if (not output.empty()) file.open(output, std::ios::binary | std::ios::trunc);
+  std::ostream &out = output.empty() ? std::cout : file;
+
+  tscl::CompressedReader reader(in);
+  tscl::SequenceChecker checker;
+  std::string partial;
+
+  while (auto block = reader.next()) {
+    out.write(block->data(), block->size());
+    if (not check_gaps) continue;
+
+    // Une ligne peut etre coupée entre deux blocs
+    std::string_view data(block->data(), block->size());
+    for (size_t end; (end = data.find('\n')) != std::string_view::npos; data.remove_prefix(end + 1)) {
+      partial.append(data.substr(0, end));
+      if (auto stamp = tscl::LogStamp::parse(partial)) checker.add(*stamp);
+      partial.clear();
+    }
+    partial.append(data);
+  }
+  out.flush();
+
+  if (check_gaps) {
+    auto gaps = checker.gaps();
+    uint64_t missing = 0;
+    for (auto const &gap : gaps) missing += gap.last - gap.first + 1;
+
+    std::cerr << checker.size() << " sequenced records, " << missing << " missing in " << gaps.size() << " gaps, "
+              << checker.duplicates() << " duplicates\n";
+    for (size_t i = 0; i < gaps.size() and i < 20; i++)
+      std::cerr << "  missing #" << gaps[i].first << " to #" << gaps[i].last << '\n';
+  }
+
+  switch (reader.status()) {
+    case tscl::CompressedReader::End: return 0;
+    case tscl::CompressedReader::Truncated:
+      std::cerr << "Warning : \"" << input << "\" is truncated, the last incomplete block was ignored\n";
+      return 2;
+    case tscl::CompressedReader::InvalidHeader:
+      std::cerr << "\"" << input << "\" is not a compressed log file\n";
+      return 1;
+    default:
+      std::cerr << "\"" << input << "\" is corrupted, decoding stopped at the first invalid block\n";
+      return 1;
+  }
+}
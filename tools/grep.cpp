@@ -0,0 +1,370 @@
+/** tscl-grep : recherche une chaine dans un fichier de logs, en utilisant son index (fichier + ".idx")
+ * pour ne parcourir que les blocs correspondant a l'intervalle de temps et aux niveaux demandés
+ *
+ * Usage : tscl-grep [-s debut] [-u fin] [-l niveau,...] [-m niveau] [-c] motif fichier
+ *   -s debut    Ignore les logs antérieurs a cette date
+ *   -u fin      Ignore les logs postérieurs a cette date
+ *   -l niveaux  N'affiche que les logs de ces niveaux
+ *   -m niveau   N'affiche que les logs de ce niveau ou d'un niveau supérieur
+ *   -c          Affiche uniquement le nombre de lignes trouvées
+ *
+ * Les dates sont exprimées en secondes depuis l'epoch, ou au format "AAAA-MM-JJ HH:MM:SS" ou
+ * "HH:MM:SS" (heure locale). Sans index, tout le fichier est parcouru. L'index écarte les blocs hors
+ * de l'intervalle, puis chaque ligne trouvée est filtrée selon sa propre date. Les lignes sans date
+ * absolue (timestamp Delta ou absent) ne sont filtrées que par bloc, et les lignes de continuation
+ * (description, pile d'appels) suivent le log auquel elles appartiennent
+ */
+
+#include <LogIndex.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <span>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+  /**
+   * @brief Projection en mémoire d'un fichier en lecture seule
+   *
+   */
+  class MappedFile {
+  private:
+    char const *m_data = nullptr;
+    size_t m_size = 0;
+
+  public:
+    explicit MappedFile(std::string const &path) {
+      int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) return;
+
+      struct stat st {};
+      if (fstat(fd, &st) == 0 and st.st_size > 0) {
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+          m_data = static_cast<char const *>(addr);
+          m_size = st.st_size;
+          madvise(addr, m_size, MADV_SEQUENTIAL);
+        }
+      }
+
+      close(fd);
+    }
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    ~MappedFile() {
+      if (m_data) munmap(const_cast<char *>(m_data), m_size);
+    }
+
+    char const *data() const { return m_data; }
+    size_t size() const { return m_size; }
+    explicit operator bool() const { return m_data != nullptr; }
+  };
+
+  /**
+   * @brief Recherche d'une sous chaine. Avec SSE2, 16 positions sont testées a la fois en comparant
+   * le premier et le dernier caractere du motif, seules les positions candidates étant vérifiées
+   *
+   */
+  char const *find(char const *begin, char const *end, std::string_view needle) {
+    size_t n = needle.size();
+    if (n == 0) return begin;
+    if (static_cast<size_t>(end - begin) < n) return end;
+
+    char const *ptr = begin;
+
+#ifdef __SSE2__
+    __m128i const first = _mm_set1_epi8(needle.front());
+    __m128i const last = _mm_set1_epi8(needle.back());
+    size_t const inner = n >= 2 ? n - 2 : 0;
+
+    for (; ptr + n - 1 + 16 <= end; ptr += 16) {
+      __m128i block_first = _mm_loadu_si128(reinterpret_cast<__m128i const *>(ptr));
+      __m128i block_last = _mm_loadu_si128(reinterpret_cast<__m128i const *>(ptr + n - 1));
+
+      auto mask = static_cast<unsigned>(
+              _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+
+      while (mask) {
+        int bit = __builtin_ctz(mask);
+        if (std::memcmp(ptr + bit + 1, needle.data() + 1, inner) == 0) return ptr + bit;
+        mask &= mask - 1;
+      }
+    }
+#endif
+
+    auto *res = static_cast<char const *>(memmem(ptr, end - ptr, needle.data(), n));
+    return res ? res : end;
+  }
+
+  /**
+   * @brief Retrouve le niveau d'une ligne de log a partir du premier "[Niveau]" qu'elle contient
+   *
+   * @return int Le niveau, ou -1 pour une ligne de continuation
+   */
+  int lineLevel(std::string_view line) {
+    line = line.substr(0, 64);
+
+    for (size_t pos = line.find('['); pos != std::string_view::npos; pos = line.find('[', pos + 1)) {
+      size_t close = line.find(']', pos);
+      if (close == std::string_view::npos) break;
+
+      auto level = tscl::Log::levelFromString(line.substr(pos + 1, close - pos - 1));
+      if (level) return *level;
+    }
+
+    return -1;
+  }
+
+  /**
+   * @brief Retrouve la date d'une ligne de log a partir de son timestamp (Partial, Full ou Precise),
+   * apres l'identité éventuelle ("#I42 t1234 ")
+   *
+   * @param reference Date proche de la ligne, donnant le jour d'un timestamp Partial
+   * @param after Vrai si la ligne est postérieure a la référence (début de son bloc d'index), faux si
+   * elle lui est antérieure (date de modification du fichier)
+   * @return std::optional<std::pair<uint64_t, uint64_t>> L'intervalle [début, fin[ couvert par le
+   * timestamp, en nanosecondes depuis l'epoch, ou std::nullopt si la ligne n'a pas de date absolue
+   */
+  std::optional<std::pair<uint64_t, uint64_t>> lineTime(std::string_view line, uint64_t reference, bool after) {
+    if (line.starts_with('#')) {
+      size_t space = line.find(' ', line.find(' ') + 1);
+      if (space == std::string_view::npos) return std::nullopt;
+      line.remove_prefix(space + 1);
+    }
+
+    char buffer[32];
+    std::memcpy(buffer, line.data(), std::min(line.size(), sizeof(buffer) - 1));
+    buffer[std::min(line.size(), sizeof(buffer) - 1)] = '\0';
+
+    std::tm tm{};
+    bool partial = false;
+    char const *end = strptime(buffer, "%d-%m-%Y %H:%M:%S", &tm);
+
+    if (not end or (*end != ' ' and *end != '.')) {
+      auto day = static_cast<std::time_t>(reference / 1000000000);
+      localtime_r(&day, &tm);
+
+      end = strptime(buffer, "%H:%M:%S", &tm);
+      if (not end or *end != ' ') return std::nullopt;
+      partial = true;
+    }
+
+    tm.tm_isdst = -1;
+    uint64_t res = static_cast<uint64_t>(std::mktime(&tm)) * 1000000000ull;
+    uint64_t precision = 1000000000ull;
+
+    if (*end == '.') {
+      uint64_t nanoseconds = 0;
+      auto [ptr, ec] = std::from_chars(end + 1, buffer + std::strlen(buffer), nanoseconds);
+      if (ec == std::errc() and ptr - end - 1 == 9) {
+        res += nanoseconds;
+        precision = 1;
+      }
+    }
+
+    // Un timestamp Partial du mauvais coté de la référence appartient au jour voisin
+    constexpr uint64_t second = 1000000000ull, day = 86400 * second;
+    if (partial and after and res + second < reference) res += day;
+    else if (partial and not after and res > reference + second)
+      res -= day;
+    return std::make_pair(res, res + precision);
+  }
+
+  std::optional<uint64_t> parseTime(std::string const &str) {
+    if (str.find_first_not_of("0123456789.") == std::string::npos)
+      return static_cast<uint64_t>(std::stod(str) * 1e9);
+
+    std::time_t now = std::time(nullptr);
+    std::tm tm = *std::localtime(&now);
+
+    // Un essai infructueux peut avoir modifié tm, qui est réinitialisé avant le suivant
+    char const *end = strptime(str.c_str(), "%Y-%m-%d %H:%M:%S", &tm);
+    if (not end) {
+      tm = *std::localtime(&now);
+      end = strptime(str.c_str(), "%H:%M:%S", &tm);
+    }
+    if (not end or *end) return std::nullopt;
+
+    tm.tm_isdst = -1;
+    return static_cast<uint64_t>(std::mktime(&tm)) * 1000000000ull;
+  }
+
+  int usage(char const *name) {
+    std::cerr << "Usage : " << name << " [-s since] [-u until] [-l level,...] [-m level] [-c] pattern file\n";
+    return 2;
+  }
+}   // namespace
+
+int main(int argc, char **argv) {
+  uint64_t since = 0, until = UINT64_MAX;
+  uint32_t levels = 0;
+  bool count_only = false;
+  std::vector<std::string> positional;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+
+    if ((arg == "-s" or arg == "-u") and i + 1 < argc) {
+      auto time = parseTime(argv[++i]);
+      if (not time) return usage(argv[0]);
+      // Une fin donnée a la seconde inclut toute cette seconde
+      if (arg == "-s") since = *time;
+      else
+        until = std::strchr(argv[i], '.') ? *time : *time + 999999999;
+    } else if (arg == "-l" and i + 1 < argc) {
+      std::string_view list = argv[++i];
+      while (not list.empty()) {
+        size_t comma = std::min(list.find(','), list.size());
+        auto level = tscl::Log::levelFromString(list.substr(0, comma));
+        if (not level) return usage(argv[0]);
+        levels |= 1u << *level;
+        list.remove_prefix(std::min(list.size(), comma + 1));
+      }
+    } else if (arg == "-m" and i + 1 < argc) {
+      auto level = tscl::Log::levelFromString(argv[++i]);
+      if (not level) return usage(argv[0]);
+      for (int l = *level; l <= tscl::Log::Fatal; l++) levels |= 1u << l;
+    } else if (arg == "-c") {
+      count_only = true;
+    } else {
+      positional.push_back(arg);
+    }
+  }
+
+  if (positional.size() != 2) return usage(argv[0]);
+  if (levels == 0) levels = ~0u;
+
+  std::string_view pattern = positional[0];
+  MappedFile log(positional[1]);
+  if (not log) {
+    if (access(positional[1].c_str(), R_OK) == 0) return 1;
+    std::cerr << "Cannot read " << positional[1] << '\n';
+    return 2;
+  }
+
+  // Intervalles du fichier a parcourir, fusionnés lorsqu'ils sont contigus
+  std::vector<std::pair<size_t, size_t>> ranges;
+  auto add_range = [&](size_t begin, size_t end) {
+    if (not ranges.empty() and ranges.back().second == begin) ranges.back().second = end;
+    else
+      ranges.emplace_back(begin, end);
+  };
+
+  // Jour de référence des timestamps Partial en l'absence d'index
+  uint64_t modified = 0;
+  if (struct stat st {}; stat(positional[1].c_str(), &st) == 0)
+    modified = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000ull;
+
+  MappedFile index(positional[1] + ".idx");
+  std::span<tscl::LogIndexEntry const> entries;
+
+  if (index and index.size() >= sizeof(tscl::LogIndexHeader)) {
+    auto *header = reinterpret_cast<tscl::LogIndexHeader const *>(index.data());
+
+    if (std::memcmp(header->magic, tscl::LogIndexHeader::expected_magic, sizeof(header->magic)) == 0 and
+        header->entry_size == sizeof(tscl::LogIndexEntry)) {
+      entries = {reinterpret_cast<tscl::LogIndexEntry const *>(index.data() + sizeof(*header)),
+                 (index.size() - sizeof(*header)) / sizeof(tscl::LogIndexEntry)};
+    }
+  }
+
+  if (entries.empty()) {
+    add_range(0, log.size());
+  } else {
+    // Les logs écrits avant l'activation de l'index ne sont pas indexés
+    if (entries.front().offset > 0) add_range(0, std::min<size_t>(entries.front().offset, log.size()));
+
+    auto first = std::partition_point(entries.begin(), entries.end(),
+                                      [&](auto const &entry) { return entry.last_timestamp < since; });
+
+    // Seul last_timestamp est croissant : un bloc plus loin peut encore contenir un log capturé plus tot
+    for (auto it = first; it != entries.end(); ++it) {
+      if (it->first_timestamp > until or not(it->levels & levels)) continue;
+
+      size_t end = it + 1 == entries.end() ? log.size() : (it + 1)->offset;
+      add_range(std::min<size_t>(it->offset, log.size()), std::min(end, log.size()));
+    }
+
+    // Les logs écrits apres la derniere entrée ne sont pas encore indexés
+    auto const &last = entries.back();
+    if (last.last_timestamp < until and (ranges.empty() or ranges.back().second != log.size()))
+      add_range(std::min<size_t>(last.offset, log.size()), log.size());
+  }
+
+  size_t matches = 0;
+  std::vector<char> out_buffer(1 << 16);
+  std::setvbuf(stdout, out_buffer.data(), _IOFBF, out_buffer.size());
+
+  for (auto [begin, end] : ranges) {
+    char const *ptr = log.data() + begin;
+    char const *range_end = log.data() + end;
+
+    while (ptr < range_end) {
+      char const *match = find(ptr, range_end, pattern);
+      if (match == range_end) break;
+
+      char const *line_begin = match;
+      while (line_begin > log.data() + begin and line_begin[-1] != '\n') line_begin--;
+
+      auto *line_end = static_cast<char const *>(std::memchr(match, '\n', range_end - match));
+      if (not line_end) line_end = range_end;
+
+      // Une ligne de continuation est filtrée comme la ligne du log auquel elle appartient
+      char const *record_begin = line_begin;
+      int level = lineLevel({line_begin, size_t(line_end - line_begin)});
+      while (level < 0 and record_begin > log.data() + begin) {
+        char const *record_end = record_begin - 1;
+        record_begin = record_end;
+        while (record_begin > log.data() + begin and record_begin[-1] != '\n') record_begin--;
+        level = lineLevel({record_begin, size_t(record_end - record_begin)});
+      }
+
+      bool accepted = level < 0 or (levels & (1u << level));
+      if (accepted and (since > 0 or until < UINT64_MAX)) {
+        uint64_t reference = modified;
+        bool after = false;
+        if (not entries.empty()) {
+          auto entry = std::partition_point(entries.begin(), entries.end(), [&](auto const &entry) {
+            return entry.offset <= static_cast<size_t>(record_begin - log.data());
+          });
+          if (entry != entries.begin()) {
+            reference = (entry - 1)->first_timestamp;
+            after = true;
+          }
+        }
+
+        auto time = lineTime({record_begin, size_t(line_end - record_begin)}, reference, after);
+        accepted = not time or (time->second > since and time->first <= until);
+      }
+
+      if (accepted) {
+        matches++;
+        if (not count_only) {
+          std::fwrite(line_begin, 1, line_end - line_begin, stdout);
+          std::fputc('\n', stdout);
+        }
+      }
+
+      ptr = line_end + 1;
+    }
+  }
+
+  if (count_only) std::printf("%zu\n", matches);
+  std::fflush(stdout);
+
+  return matches ? 0 : 1;
+}